@@ -148,9 +148,17 @@ static const uint64_t MAX_ACTIVE_CONSENSUSES = 5;
 
 static const uint64_t MAX_CONSENSUS_HISTORY  = 2 * MAX_ACTIVE_CONSENSUSES;
 
+static const uint64_t PROPOSAL_CACHE_BLOCKS = MAX_ACTIVE_CONSENSUSES;
+
 
 static constexpr uint64_t MAX_CATCHUP_DOWNLOAD_BYTES = 1000000000;
 
+static constexpr uint64_t MAX_CATCHUP_RESPONSE_BYTES = 16000000;
+
+static constexpr uint64_t MAX_CATCHUP_RESPONSE_BLOCKS = 1000;
+
+static constexpr uint64_t CATCHUP_PARALLEL_PEERS = 4;
+
 static constexpr uint64_t PROPOSAL_HASHES_PER_DB = 100000;
 
 static constexpr uint64_t MAX_TRANSACTIONS_PER_BLOCK = 10000;
@@ -172,6 +180,8 @@ static constexpr uint64_t CONNECTION_REFUSED_LOG_INTERVAL_MS = 10 * 60 * 1000;
 
 static constexpr uint32_t SOCKET_BACKLOG = 64;
 
+static constexpr uint64_t CATCHUP_STRAGGLER_MS = 10000;
+
 static constexpr size_t SHA_HASH_LEN = 32;
 
 static constexpr size_t PARTIAL_SHA_HASH_LEN = 8;
@@ -300,7 +310,37 @@ static const uint64_t  BLOCK_SIG_SHARE_DB_SIZE = 10000000;
 static const uint64_t  DA_SIG_SHARE_DB_SIZE = 10000000;
 static const uint64_t  DA_PROOF_DB_SIZE = 10000000;
 static const uint64_t  BLOCK_PROPOSAL_DB_SIZE = 100000000;
+static const uint64_t  MAX_CACHED_BLOCK_SETS = 256;
+
+static const uint64_t  LARGE_VALUE_DB_CACHE_SIZE = 64 * 1024 * 1024;
+static const uint64_t  LARGE_VALUE_DB_WRITE_BUFFER_SIZE = 16 * 1024 * 1024;
+static const uint64_t  LARGE_VALUE_DB_MAX_OPEN_FILES = 500;
+static const uint64_t  LARGE_VALUE_DB_BLOCK_SIZE = 64 * 1024;
+static const uint64_t  SMALL_VALUE_DB_CACHE_SIZE = 8 * 1024 * 1024;
+static const uint64_t  SMALL_VALUE_DB_WRITE_BUFFER_SIZE = 4 * 1024 * 1024;
+static const uint64_t  SMALL_VALUE_DB_MAX_OPEN_FILES = 100;
+static const uint64_t  SMALL_VALUE_DB_BLOCK_SIZE = 4 * 1024;
+static const uint64_t  DB_FILTER_BITS = 10;
 static const uint64_t  MAX_DELAYED_MESSAGE_SENDS = 256;
+static const uint64_t  MSG_JOURNAL_QUEUE_SIZE = 1024;
+static const uint64_t  MAX_MSG_JOURNAL_BATCH = 256;
+static const uint64_t  MSG_JOURNAL_WAIT_MS = 100;
+// off until every node parses binary messages and batch frames; old nodes only read JSON
+static const uint64_t  BINARY_NETWORK_MESSAGES = 0;
+// off until every node serves erasure coded fragments; old servers reply with plain slices
+static const uint64_t  ERASURE_CODED_FRAGMENTS = 0;
+static const uint64_t  PEER_SEND_QUEUE_SIZE = 1024;
+static const uint64_t  PEER_SEND_WAIT_MS = 100;
+static const uint64_t  MAX_PEER_SEND_BACKOFF_MS = 100;
+static const uint64_t  DEFERRED_MESSAGES_WAIT_MS = 1000;
+static const uint64_t  MAX_SERVER_WORKER_THREADS = 16;
+static const uint64_t  SERVER_EPOLL_MAX_EVENTS = 64;
+static const uint64_t  SERVER_EPOLL_WAIT_MS = 100;
+static const uint64_t  SERVER_REQUEST_WAIT_MS = 10000;
+static const uint64_t  CLIENT_SOCKET_IDLE_MS = 5000;
+static const uint64_t  NETWORK_READ_TIMEOUT_MS = 3000;
+static const uint64_t  NETWORK_BULK_READ_TIMEOUT_MS = 60000;
+static const uint64_t  MAX_IDLE_SOCKETS_PER_PEER = 4;
 static const uint64_t  MAX_PROPOSAL_QUEUE_SIZE = 8;
 
 
@@ -34,6 +34,7 @@
 #include "exceptions/FatalError.h"
 #include "exceptions/NetworkProtocolException.h"
 #include "network/ClientSocket.h"
+#include "network/ClientSocketPool.h"
 #include "network/IO.h"
 
 #include "SkaleCommon.h"
@@ -80,21 +81,13 @@ uint64_t AbstractClientAgent::incrementAndReturnThreadCounter() {
 void AbstractClientAgent::sendItem(ptr<DataStructure> _item, schain_index _dstIndex) {
     ASSERT( getNode()->isStarted() );
 
-    auto socket = make_shared<ClientSocket >( *sChain, _dstIndex, portType );
-
-
-    try {
-        getSchain()->getIo()->writeMagic( socket );
-    }
-
-    catch ( ExitRequestedException& ) {
-        throw;
-    } catch ( ... ) {
-        throw_with_nested( NetworkProtocolException( "Could not write magic", __CLASS_NAME__ ) );
-    }
-
+    auto socket = sChain->getClientSocketPool()->acquire( _dstIndex, portType );
 
+    // sendItemImpl starts the exchange with writeRequest, which sends the magic with the first header
     sendItemImpl(_item, socket, _dstIndex);
+
+    // the exchange completed, so the connection can carry the next one
+    sChain->getClientSocketPool()->release( socket );
 }
 
 
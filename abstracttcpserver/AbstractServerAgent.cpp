@@ -60,6 +60,12 @@
 #include "datastructures/PartialHashesList.h"
 
 
+#include "utils/Time.h"
+
+#include <sys/epoll.h>
+#include <netinet/tcp.h>
+#include <fcntl.h>
+
 #include "AbstractServerAgent.h"
 
 
@@ -107,7 +113,7 @@ void AbstractServerAgent::workerThreadConnectionProcessingLoop(void *_params) {
 
             connection = server->workerThreadWaitandPopConnection();
             server->processNextAvailableConnection(connection);;
-            connection->closeConnection();
+            server->waitForNextRequest(connection);
         } catch (exception &e) {
             Exception::logNested(e);
             if (connection != nullptr)
@@ -118,15 +124,14 @@ void AbstractServerAgent::workerThreadConnectionProcessingLoop(void *_params) {
 
 
 void AbstractServerAgent::send(ptr<ServerConnection> _connectionEnvelope,
-                               ptr<Header> _header) {
+                               ptr<Header> _header, ptr<vector<uint8_t>> _body) {
 
 
     ASSERT(_connectionEnvelope);
     ASSERT(_header);
     ASSERT(_header->isComplete());
-    auto buf = _header->toBuffer();
 
-    getSchain()->getIo()->writeBuf(_connectionEnvelope->getDescriptor(), buf);
+    getSchain()->getIo()->writeMessage(_connectionEnvelope->getDescriptor(), false, _header, _body);
 }
 
 AbstractServerAgent::AbstractServerAgent(const string &_name, Schain &_schain,
@@ -138,6 +143,109 @@ AbstractServerAgent::AbstractServerAgent(const string &_name, Schain &_schain,
 
 AbstractServerAgent::~AbstractServerAgent() {
     this->networkReadThread->join();
+    if (epollFd >= 0)
+        close(epollFd);
+}
+
+num_threads AbstractServerAgent::getWorkerThreadCount(Schain &_sChain) {
+    uint64_t peers = (uint64_t) _sChain.getNodeCount() - 1;
+    return num_threads(max((uint64_t) 1, min(peers, MAX_SERVER_WORKER_THREADS)));
+}
+
+void AbstractServerAgent::acceptNewConnections(int _listenSocket) {
+
+    struct sockaddr_in clientAddress;
+    socklen_t sizeOfClientAddress = sizeof(clientAddress);
+
+    // the listen socket is non-blocking, so accept everything that is pending
+    while (true) {
+        int newConnection = accept(_listenSocket, (sockaddr *) &clientAddress, &sizeOfClientAddress);
+
+        if (newConnection < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                return;
+            BOOST_THROW_EXCEPTION(NetworkProtocolException("accept failed:" + string(strerror(errno)), __CLASS_NAME__));
+        }
+
+        int one = 1;
+        setsockopt(newConnection, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        char *ip(inet_ntoa(clientAddress.sin_addr));
+
+        waitForNextRequest(make_shared<ServerConnection>(newConnection, make_shared<string>(ip)));
+    }
+}
+
+void AbstractServerAgent::waitForNextRequest(ptr<ServerConnection> _connection) {
+
+    int descriptor = (int) _connection->getDescriptor();
+
+    if (descriptor <= 0 || epollFd < 0) {
+        _connection->closeConnection();
+        return;
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.fd = descriptor;
+
+    lock_guard<mutex> lock(waitingConnectionsMutex);
+
+    waitingConnections[descriptor] = {_connection, Time::getCurrentTimeMs()};
+
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, descriptor, &event) < 0) {
+        LOG(err, "epoll_ctl failed:" + string(strerror(errno)));
+        waitingConnections.erase(descriptor);
+        _connection->closeConnection();
+    }
+}
+
+void AbstractServerAgent::dispatchReadyConnection(int _descriptor) {
+
+    ptr<ServerConnection> connection;
+
+    {
+        lock_guard<mutex> lock(waitingConnectionsMutex);
+
+        auto it = waitingConnections.find(_descriptor);
+
+        if (it == waitingConnections.end())
+            return;
+
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, _descriptor, nullptr);
+
+        connection = it->second.first;
+
+        waitingConnections.erase(it);
+    }
+
+    char c;
+
+    if (recv(_descriptor, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 0) {
+        // the client closed a kept-alive connection
+        connection->closeConnection();
+        return;
+    }
+
+    pushToQueueAndNotifyWorkers(connection);
+}
+
+void AbstractServerAgent::closeStaleConnections() {
+
+    auto now = Time::getCurrentTimeMs();
+
+    lock_guard<mutex> lock(waitingConnectionsMutex);
+
+    for (auto it = waitingConnections.begin(); it != waitingConnections.end();) {
+        if (now - it->second.second > SERVER_REQUEST_WAIT_MS) {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, it->first, nullptr);
+            it->second.first->closeConnection();
+            it = waitingConnections.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 void AbstractServerAgent::acceptTCPConnectionsLoop() {
@@ -146,32 +254,76 @@ void AbstractServerAgent::acceptTCPConnectionsLoop() {
 
     waitOnGlobalStartBarrier();
 
-    struct sockaddr_in clientAddress;
-    socklen_t sizeOfClientAddress = sizeof(clientAddress);
     ASSERT(this->socket > 0);
     auto s = this->socket->getDescriptor();
     ASSERT(s > 0);
     try {
 
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+        if (epollFd < 0) {
+            BOOST_THROW_EXCEPTION(FatalError("epoll_create1 failed:" + string(strerror(errno))));
+        }
+
+        fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+
+        struct epoll_event listenEvent;
+        memset(&listenEvent, 0, sizeof(listenEvent));
+        listenEvent.events = EPOLLIN;
+        listenEvent.data.fd = s;
+
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, s, &listenEvent) < 0) {
+            BOOST_THROW_EXCEPTION(FatalError("epoll_ctl failed:" + string(strerror(errno))));
+        }
+
+        // wakes epoll_wait as soon as exit is requested
+        auto exitFd = getNode()->getExitEventFd();
+
+        struct epoll_event exitEvent;
+        memset(&exitEvent, 0, sizeof(exitEvent));
+        exitEvent.events = EPOLLIN;
+        exitEvent.data.fd = exitFd;
+
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, exitFd, &exitEvent) < 0) {
+            BOOST_THROW_EXCEPTION(FatalError("epoll_ctl failed:" + string(strerror(errno))));
+        }
+
+        vector<struct epoll_event> events(SERVER_EPOLL_MAX_EVENTS);
+
         while (!getSchain()->getNode()->isExitRequested()) {
 
-            int newConnection = accept(s, (sockaddr *) &clientAddress, &sizeOfClientAddress);
+            int count = epoll_wait(epollFd, events.data(), events.size(), SERVER_EPOLL_WAIT_MS);
 
             if (getSchain()->getNode()->isExitRequested()) {
                 return;
             }
 
-            if (newConnection < 0) {
-                BOOST_THROW_EXCEPTION(NetworkProtocolException("accept failed:" + string(strerror(errno)), __CLASS_NAME__));
+            if (count < 0 && errno != EINTR) {
+                BOOST_THROW_EXCEPTION(FatalError("epoll_wait failed:" + string(strerror(errno))));
             }
 
-            char *ip(inet_ntoa(clientAddress.sin_addr));
-
-            this->pushToQueueAndNotifyWorkers(make_shared<ServerConnection>(newConnection, make_shared<string>(ip)));
+            for (int i = 0; i < count; i++) {
+                try {
+                    if (events.at(i).data.fd == s) {
+                        acceptNewConnections(s);
+                    } else {
+                        dispatchReadyConnection(events.at(i).data.fd);
+                    }
+                } catch (ExitRequestedException &) {
+                    return;
+                } catch (FatalError &) {
+                    throw;
+                } catch (exception &e) {
+                    Exception::logNested(e);
+                }
+            }
 
+            closeStaleConnections();
         }
     } catch (FatalError *e) {
         getNode()->exitOnFatalError(e->getMessage());
+    } catch (FatalError &e) {
+        getNode()->exitOnFatalError(e.getMessage());
     }
 }
 
@@ -49,9 +49,26 @@ protected:
 
     condition_variable incomingTCPConnectionsCond;
 
+    // the accept loop watches the listen socket and all accepted connections with epoll,
+    // and hands a connection to the workers only once its request arrived
+    int epollFd = -1;
 
+    // connections waiting for their next request, with the time they started waiting
+    map<int, pair<ptr<ServerConnection>, uint64_t>> waitingConnections;
 
-    void send(ptr<ServerConnection> _connectionEnvelope, ptr<Header> _header);
+    mutex waitingConnectionsMutex;
+
+    void acceptNewConnections(int _listenSocket);
+
+    // clients keep connections open between exchanges, so a served connection goes back to epoll
+    void waitForNextRequest(ptr<ServerConnection> _connection);
+
+    void dispatchReadyConnection(int _descriptor);
+
+    void closeStaleConnections();
+
+    // the header and the optional body go out in one write
+    void send(ptr<ServerConnection> _connectionEnvelope, ptr<Header> _header, ptr<vector<uint8_t>> _body = nullptr);
 
 
 
@@ -88,6 +105,9 @@ public:
 
     void acceptTCPConnectionsLoop();
 
+    // one worker per peer, up to MAX_SERVER_WORKER_THREADS
+    static num_threads getWorkerThreadCount(Schain &_sChain);
+
 
     void createNetworkReadThread();
 };
@@ -0,0 +1,198 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file BlockFinalizeDownloadAgent.cpp
+    @author Stan Kladko
+    @date 2019
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/ExitRequestedException.h"
+#include "exceptions/FatalError.h"
+#include "exceptions/InvalidStateException.h"
+
+#include "thirdparty/json.hpp"
+
+#include "chains/Schain.h"
+#include "node/Node.h"
+#include "crypto/ThresholdSignature.h"
+#include "datastructures/BlockProposal.h"
+#include "db/BlockProposalDB.h"
+
+#include "BlockFinalizeDownloader.h"
+#include "BlockFinalizeDownloaderThreadPool.h"
+#include "BlockFinalizeDownloadAgent.h"
+
+
+BlockFinalizeDownloadAgent::BlockFinalizeDownloadAgent(Schain &_sChain) : Agent(_sChain, false) {
+    try {
+        logThreadLocal_ = _sChain.getNode()->getLog();
+
+        if (_sChain.getNodeCount() > 1) {
+            // every peer may be asked for fragments of the same proposal at once
+            threadPool = make_shared<BlockFinalizeDownloaderThreadPool>(
+                    (uint64_t) _sChain.getNodeCount() - 1, this);
+            threadPool->startService();
+        }
+    } catch (ExitRequestedException &) { throw; } catch (...) {
+        throw_with_nested(FatalError(__FUNCTION__, __CLASS_NAME__));
+    }
+}
+
+
+void BlockFinalizeDownloadAgent::startDownload(block_id _blockId, schain_index _proposerIndex,
+                                               ptr<ThresholdSignature> _thresholdSig) {
+
+    CHECK_ARGUMENT(_thresholdSig != nullptr);
+
+    // a single node chain has no peers to download from, so decideBlock commits directly
+    CHECK_STATE(threadPool != nullptr);
+
+    {
+        lock_guard<mutex> lock(messageMutex);
+
+        if (activeDownloads.count(_blockId) > 0)
+            return;
+
+        auto downloader = make_shared<BlockFinalizeDownloader>(sChain, _blockId, _proposerIndex, _thresholdSig);
+
+        activeDownloads[_blockId] = downloader;
+
+        auto nodeCount = (uint64_t) sChain->getNodeCount();
+
+        for (uint64_t i = 1; i <= nodeCount; i++) {
+            if (schain_index(i) == sChain->getSchainIndex())
+                continue;
+            downloader->taskStarted();
+            tasks.emplace_back(downloader, schain_index(i));
+        }
+    }
+
+    messageCond.notify_all();
+}
+
+
+void BlockFinalizeDownloadAgent::cancelDownloads(block_id _lastCommittedBlockID) {
+
+    lock_guard<mutex> lock(messageMutex);
+
+    for (auto &&item : activeDownloads) {
+        if (item.first <= _lastCommittedBlockID)
+            item.second->cancel();
+    }
+
+    // queued tasks of cancelled downloads are dropped without waiting for a worker
+    for (auto it = tasks.begin(); it != tasks.end();) {
+        auto downloader = it->first;
+        if (downloader->getBlockId() > _lastCommittedBlockID) {
+            ++it;
+            continue;
+        }
+        it = tasks.erase(it);
+        // the block is already committed, so there is nothing to finish
+        if (downloader->taskFinished())
+            activeDownloads.erase(downloader->getBlockId());
+    }
+}
+
+
+uint64_t BlockFinalizeDownloadAgent::getActiveDownloadCount() {
+    lock_guard<mutex> lock(messageMutex);
+    return activeDownloads.size();
+}
+
+
+void BlockFinalizeDownloadAgent::finishDownload(ptr<BlockFinalizeDownloader> _downloader) {
+
+    {
+        lock_guard<mutex> lock(messageMutex);
+        activeDownloads.erase(_downloader->getBlockId());
+    }
+
+    auto blockId = _downloader->getBlockId();
+
+    if (blockId <= sChain->getLastCommittedBlockID())
+        return; // the block arrived through catchup first
+
+    auto proposal = _downloader->getDownloadedProposal();
+
+    if (proposal == nullptr)
+        return;
+
+    getNode()->getBlockProposalDB()->addBlockProposal(proposal);
+
+    sChain->blockCommitArrived(blockId, _downloader->getProposerIndex(), proposal->getTimeStamp(),
+                               proposal->getTimeStampMs(), _downloader->getThresholdSig());
+}
+
+
+void BlockFinalizeDownloadAgent::workerThreadTaskLoop(BlockFinalizeDownloadAgent *agent) {
+
+    setThreadName("BlckFinLoop", agent->getNode()->getConsensusEngine());
+
+    agent->getNode()->waitOnGlobalClientStartBarrier();
+
+    try {
+        while (!agent->getNode()->isExitRequested()) {
+
+            ptr<BlockFinalizeDownloader> downloader = nullptr;
+            schain_index dstIndex = 0;
+
+            {
+                unique_lock<mutex> mlock(agent->messageMutex);
+
+                while (agent->tasks.empty()) {
+                    agent->getNode()->exitCheck();
+                    agent->messageCond.wait(mlock);
+                }
+
+                downloader = agent->tasks.front().first;
+                dstIndex = agent->tasks.front().second;
+                agent->tasks.pop_front();
+            }
+
+            try {
+                downloader->downloadFromPeer(dstIndex);
+            } catch (ExitRequestedException &) {
+                return;
+            } catch (exception &e) {
+                Exception::logNested(e);
+            }
+
+            if (!downloader->taskFinished())
+                continue;
+
+            try {
+                agent->finishDownload(downloader);
+            } catch (ExitRequestedException &) {
+                return;
+            } catch (exception &e) {
+                Exception::logNested(e);
+            }
+        }
+    } catch (ExitRequestedException &) {
+        return;
+    } catch (FatalError *e) {
+        agent->getNode()->exitOnFatalError(e->getMessage());
+    }
+}
+
+
+BlockFinalizeDownloadAgent::~BlockFinalizeDownloadAgent() {
+}
@@ -0,0 +1,60 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file BlockFinalizeDownloadAgent.h
+    @author Stan Kladko
+    @date 2019
+*/
+
+#pragma once
+
+#include "Agent.h"
+
+class Schain;
+class ThresholdSignature;
+class BlockFinalizeDownloader;
+class BlockFinalizeDownloaderThreadPool;
+
+// long-lived pool of finalize download workers, so that decideBlock does not wait for the network
+class BlockFinalizeDownloadAgent : public Agent {
+
+    // one task per (download, peer) pair
+    deque<pair<ptr<BlockFinalizeDownloader>, schain_index>> tasks;
+
+    map<block_id, ptr<BlockFinalizeDownloader>> activeDownloads;
+
+    ptr<BlockFinalizeDownloaderThreadPool> threadPool = nullptr;
+
+    void finishDownload(ptr<BlockFinalizeDownloader> _downloader);
+
+public:
+
+    explicit BlockFinalizeDownloadAgent(Schain &_sChain);
+
+    // the block is committed by a worker once enough fragments arrived
+    void startDownload(block_id _blockId, schain_index _proposerIndex, ptr<ThresholdSignature> _thresholdSig);
+
+    // drops queued tasks and aborts in-flight requests for blocks already committed
+    void cancelDownloads(block_id _lastCommittedBlockID);
+
+    uint64_t getActiveDownloadCount();
+
+    static void workerThreadTaskLoop(BlockFinalizeDownloadAgent *agent);
+
+    virtual ~BlockFinalizeDownloadAgent();
+};
@@ -59,6 +59,7 @@
 #include "abstracttcpserver/ConnectionStatus.h"
 
 #include "network/ClientSocket.h"
+#include "network/ClientSocketPool.h"
 #include "network/IO.h"
 #include "network/TransportNetwork.h"
 #include "node/Node.h"
@@ -70,6 +71,7 @@
 #include "datastructures/CommittedBlockList.h"
 #include "datastructures/BlockProposalFragment.h"
 #include "datastructures/BlockProposalFragmentList.h"
+#include "datastructures/ErasureCoder.h"
 #include "datastructures/BlockProposalSet.h"
 #include "datastructures/BlockProposal.h"
 #include "db/BlockProposalDB.h"
@@ -81,14 +83,17 @@
 #include "pendingqueue/PendingTransactionsAgent.h"
 
 #include "BlockFinalizeDownloader.h"
-#include "BlockFinalizeDownloaderThreadPool.h"
 
 
-BlockFinalizeDownloader::BlockFinalizeDownloader(Schain *_sChain, block_id _blockId, schain_index _proposerIndex)
+BlockFinalizeDownloader::BlockFinalizeDownloader(Schain *_sChain, block_id _blockId, schain_index _proposerIndex,
+                                                 ptr<ThresholdSignature> _thresholdSig)
         : Agent(*_sChain, false, true),
           blockId(_blockId),
           proposerIndex(_proposerIndex),
-          fragmentList(_blockId, (uint64_t) _sChain->getNodeCount() - 1) {
+          thresholdSig(_thresholdSig),
+          fragmentList(_blockId, (uint64_t) _sChain->getNodeCount() - 1,
+                       _sChain->getNode()->isErasureCodedFragments() ?
+                       ErasureCoder::getDataShardCount((uint64_t) _sChain->getNodeCount() - 1) : 0) {
 
     CHECK_ARGUMENT(_sChain != nullptr);
 
@@ -99,7 +104,8 @@ BlockFinalizeDownloader::BlockFinalizeDownloader(Schain *_sChain, block_id _bloc
 
         CHECK_STATE(sChain != nullptr);
 
-        threadCounter = 0;
+        cancelled = false;
+        pendingTasks = 0;
 
 
     }
@@ -116,25 +122,73 @@ nlohmann::json BlockFinalizeDownloader::readBlockFinalizeResponseHeader(ptr<Clie
 }
 
 
+void BlockFinalizeDownloader::addInFlightSocket(ptr<ClientSocket> _socket) {
+    lock_guard<mutex> lock(inFlightMutex);
+    inFlightSockets.insert(_socket);
+    // cancel() may have run before the socket was registered
+    if (cancelled)
+        shutdown((int) _socket->getDescriptor(), SHUT_RDWR);
+}
+
+void BlockFinalizeDownloader::removeInFlightSocket(ptr<ClientSocket> _socket) {
+    if (_socket == nullptr)
+        return;
+    lock_guard<mutex> lock(inFlightMutex);
+    inFlightSockets.erase(_socket);
+}
+
+void BlockFinalizeDownloader::cancel() {
+
+    lock_guard<mutex> lock(inFlightMutex);
+
+    cancelled = true;
+
+    // a shut down socket fails the blocked read at once, and is not returned to the pool
+    for (auto &&socket : inFlightSockets) {
+        shutdown((int) socket->getDescriptor(), SHUT_RDWR);
+    }
+}
+
+bool BlockFinalizeDownloader::isCancelled() {
+    return cancelled;
+}
+
+void BlockFinalizeDownloader::taskStarted() {
+    pendingTasks++;
+}
+
+bool BlockFinalizeDownloader::taskFinished() {
+    return --pendingTasks == 0;
+}
+
+block_id BlockFinalizeDownloader::getBlockId() const {
+    return blockId;
+}
+
+schain_index BlockFinalizeDownloader::getProposerIndex() const {
+    return proposerIndex;
+}
+
+ptr<ThresholdSignature> BlockFinalizeDownloader::getThresholdSig() const {
+    return thresholdSig;
+}
+
+
 uint64_t BlockFinalizeDownloader::downloadFragment(schain_index _dstIndex, fragment_index _fragmentIndex) {
 
+    ptr<ClientSocket> socket = nullptr;
 
     try {
 
-        auto header = make_shared<BlockFinalizeRequestHeader>(*sChain, blockId, proposerIndex, _fragmentIndex);
-        auto socket = make_shared<ClientSocket>(*sChain, _dstIndex, CATCHUP);
+        auto header = make_shared<BlockFinalizeRequestHeader>(*sChain, blockId, proposerIndex, _fragmentIndex,
+                                                              fragmentList.getDataFragments() > 0);
+        socket = sChain->getClientSocketPool()->acquire(_dstIndex, CATCHUP);
+        addInFlightSocket(socket);
         auto io = getSchain()->getIo();
 
 
         try {
-            io->writeMagic(socket);
-        } catch (ExitRequestedException &) { throw; } catch (...) {
-            throw_with_nested(
-                    NetworkProtocolException("BlockFinalizec: Server disconnect sending magic", __CLASS_NAME__));
-        }
-
-        try {
-            io->writeHeader(socket, header);
+            io->writeRequest(socket, header);
         } catch (ExitRequestedException &) { throw; } catch (...) {
             auto errString = "BlockFinalizec step 1: can not write BlockFinalize request";
             LOG(debug, errString);
@@ -159,6 +213,8 @@ uint64_t BlockFinalizeDownloader::downloadFragment(schain_index _dstIndex, fragm
 
         if (status == CONNECTION_DISCONNECT) {
             LOG(debug, "BlockFinalizec got response::no fragment");
+            removeInFlightSocket(socket);
+            sChain->getClientSocketPool()->release(socket);
             return fragmentList.nextIndexToRetrieve();
         }
 
@@ -181,15 +237,27 @@ uint64_t BlockFinalizeDownloader::downloadFragment(schain_index _dstIndex, fragm
         }
 
 
+        removeInFlightSocket(socket);
+        sChain->getClientSocketPool()->release(socket);
+
         uint64_t next = 0;
 
         fragmentList.addFragment(blockFragment, next);
 
         LOG(debug, "BlockFinalizec success");
 
+        if (fragmentList.isComplete()) {
+            // abort the requests still waiting on slower peers
+            cancel();
+        }
+
         return next;
 
-    } catch (ExitRequestedException &e) { throw; } catch (...) {
+    } catch (ExitRequestedException &e) {
+        removeInFlightSocket(socket);
+        throw;
+    } catch (...) {
+        removeInFlightSocket(socket);
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
     }
 
@@ -216,6 +284,23 @@ uint64_t BlockFinalizeDownloader::readBlockSize(nlohmann::json _responseHeader)
     return result;
 };
 
+ptr<vector<ptr<string>>> BlockFinalizeDownloader::readFragmentHashes(nlohmann::json _responseHeader) {
+
+    auto jsonHashes = _responseHeader["fragmentHashes"];
+
+    if (!jsonHashes.is_array()) {
+        BOOST_THROW_EXCEPTION(NetworkProtocolException("fragmentHashes is not an array", __CLASS_NAME__));
+    }
+
+    auto result = make_shared<vector<ptr<string>>>();
+
+    for (auto &&hash : jsonHashes) {
+        result->push_back(make_shared<string>(hash.get<string>()));
+    }
+
+    return result;
+};
+
 ptr<string> BlockFinalizeDownloader::readBlockHash(nlohmann::json _responseHeader) {
     auto result = Header::getString(_responseHeader, "blockHash");
     return result;
@@ -237,7 +322,7 @@ BlockFinalizeDownloader::readBlockFragment(ptr<ClientSocket> _socket, nlohmann::
 
     try {
         getSchain()->getIo()->readBytes(_socket->getDescriptor(), serializedFragment,
-                                        msg_len(fragmentSize));
+                                        msg_len(fragmentSize), NETWORK_BULK_READ_TIMEOUT_MS);
     } catch (ExitRequestedException &) {
         throw;
     } catch (...) {
@@ -247,9 +332,26 @@ BlockFinalizeDownloader::readBlockFragment(ptr<ClientSocket> _socket, nlohmann::
     ptr<BlockProposalFragment> fragment = nullptr;
 
     try {
-        fragment = make_shared<BlockProposalFragment>(blockId, (uint64_t) _nodeCount - 1,
-                                                      _fragmentIndex, serializedFragment,
-                                                      blockSize, blockHash);
+        auto dataFragments = fragmentList.getDataFragments();
+
+        if (dataFragments == 0) {
+            fragment = make_shared<BlockProposalFragment>(blockId, (uint64_t) _nodeCount - 1,
+                                                          _fragmentIndex, serializedFragment,
+                                                          blockSize, blockHash);
+        } else {
+            if (responseHeader.find("dataFragments") == responseHeader.end()) {
+                BOOST_THROW_EXCEPTION(NetworkProtocolException(
+                        "Server does not support erasure coded fragments", __CLASS_NAME__));
+            }
+            if (Header::getUint64(responseHeader, "dataFragments") != dataFragments) {
+                BOOST_THROW_EXCEPTION(NetworkProtocolException("Server sent incorrect dataFragments",
+                                                               __CLASS_NAME__));
+            }
+            fragment = make_shared<BlockProposalFragment>(blockId, (uint64_t) _nodeCount - 1,
+                                                          _fragmentIndex, serializedFragment,
+                                                          blockSize, blockHash, dataFragments,
+                                                          readFragmentHashes(responseHeader));
+        }
     } catch (ExitRequestedException &) { throw; } catch (...) {
         throw_with_nested(NetworkProtocolException("Could not parse block fragment", __CLASS_NAME__));
     }
@@ -260,75 +362,56 @@ BlockFinalizeDownloader::readBlockFragment(ptr<ClientSocket> _socket, nlohmann::
 }
 
 
-void BlockFinalizeDownloader::workerThreadFragmentDownloadLoop(BlockFinalizeDownloader *agent, schain_index _dstIndex) {
-
-    setThreadName("BlckFinLoop", agent->getSchain()->getNode()->getConsensusEngine());
+void BlockFinalizeDownloader::downloadFromPeer(schain_index _dstIndex) {
 
     uint64_t next = (uint64_t) _dstIndex;
 
-    agent->getSchain()->getNode()->waitOnGlobalClientStartBarrier();
-
-    if (next > (uint64_t) agent->getSchain()->getSchainIndex())
+    if (next > (uint64_t) getSchain()->getSchainIndex())
         next--;
 
-    auto sChain = agent->getSchain();
-
-    bool testFinalizationDownloadOnly = agent->getSchain()->getNode()->getTestConfig()->isFinalizationDownloadOnly();
+    bool testFinalizationDownloadOnly = getSchain()->getNode()->getTestConfig()->isFinalizationDownloadOnly();
 
+    while (!sChain->getNode()->isExitRequested() && !isCancelled()) {
 
-    try {
-
-        while (!sChain->getNode()->isExitRequested()) {
+        // with erasure coding the slowest peers are not needed once enough fragments arrived
+        if (fragmentList.isComplete()) {
+            return;
+        }
 
-            if (!testFinalizationDownloadOnly) {
-                // take into account that the same block can come through catchup
-                if (agent->getSchain()->getLastCommittedBlockID() >= agent->blockId ||
-                    agent->getSchain()->getNode()->getBlockProposalDB()->proposalExists(
-                            agent->blockId,
-                            agent->proposerIndex)) {
-                    return;
-                }
+        if (!testFinalizationDownloadOnly) {
+            // take into account that the same block can come through catchup
+            if (getSchain()->getLastCommittedBlockID() >= blockId ||
+                getSchain()->getNode()->getBlockProposalDB()->proposalExists(blockId, proposerIndex)) {
+                return;
             }
+        }
 
-
-            try {
-                next = agent->downloadFragment(_dstIndex, next);
-                if (next == 0) {
-                    return;
-                }
-            } catch (ExitRequestedException &) {
+        try {
+            next = downloadFragment(_dstIndex, next);
+            if (next == 0) {
                 return;
-            }   catch (ConnectionRefusedException& e) {
-                agent->logConnectionRefused(e, _dstIndex);
-                usleep( agent->getNode()->getWaitAfterNetworkErrorMs() * 1000 );
-            } catch (exception &e) {
-                Exception::logNested(e);
-                usleep( agent->getNode()->getWaitAfterNetworkErrorMs() * 1000 );
             }
-        };
-    } catch (FatalError *e) {
-        agent->getSchain()->getNode()->exitOnFatalError(e->getMessage());
+        } catch (ExitRequestedException &) {
+            throw;
+        } catch (ConnectionRefusedException &e) {
+            logConnectionRefused(e, _dstIndex);
+            usleep(getNode()->getWaitAfterNetworkErrorMs() * 1000);
+        } catch (exception &e) {
+            if (isCancelled())
+                return;
+            Exception::logNested(e);
+            usleep(getNode()->getWaitAfterNetworkErrorMs() * 1000);
+        }
     }
 }
 
-ptr<BlockProposal> BlockFinalizeDownloader::downloadProposal() {
+ptr<BlockProposal> BlockFinalizeDownloader::getDownloadedProposal() {
 
     MONITOR(__CLASS_NAME__, __FUNCTION__);
 
-    {
-
-
-        threadPool = make_shared<BlockFinalizeDownloaderThreadPool>((uint64_t) getSchain()->getNodeCount(), this);
-        threadPool->startService();
-        threadPool->joinAll();
-
-    }
-
     try {
-
         if (fragmentList.isComplete()) {
-            auto block = BlockProposal::deserialize(fragmentList.serialize(), getSchain()->getCryptoManager());
-            return block;
+            return BlockProposal::deserialize(fragmentList.serialize(), getSchain()->getCryptoManager());
         } else {
             return nullptr;
         }
@@ -55,8 +55,8 @@ class BlockFinalizeResponseHeader;
 class BlockProposalFragment;
 class BlockProposalFragmentList;
 
-class BlockFinalizeDownloaderThreadPool;
 class BlockProposalSet;
+class ThresholdSignature;
 
 #include "datastructures/BlockProposalFragmentList.h"
 
@@ -68,24 +68,49 @@ class BlockFinalizeDownloader : public Agent {
 
     BlockProposalFragmentList fragmentList;
 
+    ptr<ThresholdSignature> thresholdSig;
 
-public:
+    atomic<bool> cancelled;
+
+    // peers still being downloaded from by the BlockFinalizeDownloadAgent workers
+    atomic<uint64_t> pendingTasks;
+
+    mutex inFlightMutex;
 
+    set<ptr<ClientSocket>> inFlightSockets;
 
+    void addInFlightSocket(ptr<ClientSocket> _socket);
 
-    atomic< uint64_t > threadCounter;
+    void removeInFlightSocket(ptr<ClientSocket> _socket);
 
-    ptr<BlockFinalizeDownloaderThreadPool> threadPool = nullptr;
 
-    BlockFinalizeDownloader(Schain *_sChain, block_id _blockId, schain_index _proposerIndex);
+public:
+
+    BlockFinalizeDownloader(Schain *_sChain, block_id _blockId, schain_index _proposerIndex,
+                            ptr<ThresholdSignature> _thresholdSig);
 
 
     virtual ~BlockFinalizeDownloader();
 
     uint64_t downloadFragment(schain_index _dstIndex, fragment_index _fragmentIndex);
 
+    // requests fragments from one peer until the proposal is complete, committed or cancelled
+    void downloadFromPeer(schain_index _dstIndex);
+
+    void cancel();
 
-    static void workerThreadFragmentDownloadLoop(BlockFinalizeDownloader* agent, schain_index _dstIndex );
+    bool isCancelled();
+
+    void taskStarted();
+
+    // returns true for the last task, which then finishes the download
+    bool taskFinished();
+
+    block_id getBlockId() const;
+
+    schain_index getProposerIndex() const;
+
+    ptr<ThresholdSignature> getThresholdSig() const;
 
     nlohmann::json readBlockFinalizeResponseHeader( ptr< ClientSocket > _socket );
 
@@ -96,10 +121,13 @@ public:
 
     uint64_t readFragmentSize(nlohmann::json _responseHeader);
 
-    ptr<BlockProposal> downloadProposal();
+    // nullptr if the download was cancelled before enough fragments arrived
+    ptr<BlockProposal> getDownloadedProposal();
 
     uint64_t readBlockSize(nlohmann::json _responseHeader);
 
     ptr<string> readBlockHash(nlohmann::json _responseHeader);
+
+    ptr<vector<ptr<string>>> readFragmentHashes(nlohmann::json _responseHeader);
 };
 
@@ -39,7 +39,7 @@
 
 #include "thirdparty/json.hpp"
 
-#include "BlockFinalizeDownloader.h"
+#include "BlockFinalizeDownloadAgent.h"
 #include "BlockFinalizeDownloaderThreadPool.h"
 
 BlockFinalizeDownloaderThreadPool::BlockFinalizeDownloaderThreadPool(
@@ -48,38 +48,15 @@ BlockFinalizeDownloaderThreadPool::BlockFinalizeDownloaderThreadPool(
 }
 
 
-void BlockFinalizeDownloaderThreadPool::createThread(uint64_t number) {
+void BlockFinalizeDownloaderThreadPool::createThread(uint64_t /*number*/) {
 
-    auto p = (BlockFinalizeDownloader*)agent;
+    auto a = (BlockFinalizeDownloadAgent*) agent;
 
-    uint64_t index = number + 1;
-
-    if (index == p->getSchain()->getSchainIndex())
-        return;
-
-    this->threadpool.push_back(make_shared<thread>(
-            BlockFinalizeDownloader::workerThreadFragmentDownloadLoop, p, index));
+    this->threadpool.push_back(make_shared<thread>(BlockFinalizeDownloadAgent::workerThreadTaskLoop, a));
 
 }
 
 
-void BlockFinalizeDownloaderThreadPool::startService() {
-
-    for (uint64_t i = 0; i < (uint64_t )numThreads; i++) {
-        createThread(i);
-    }
-
-}
-
 BlockFinalizeDownloaderThreadPool::~BlockFinalizeDownloaderThreadPool() {
-
-    assert(joined);
-
-    for (auto&& t : threadpool) {
-        assert (!t->joinable());
-    }
-
-    threadpool.clear();
-
 }
 
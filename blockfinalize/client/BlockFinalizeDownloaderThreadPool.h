@@ -35,8 +35,6 @@ public:
 
     void createThread(uint64_t number) override;
 
-    void startService() override;
-
     virtual ~BlockFinalizeDownloaderThreadPool();
 
 };
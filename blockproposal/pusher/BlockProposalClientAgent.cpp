@@ -162,7 +162,7 @@ void BlockProposalClientAgent::sendBlockProposal(ptr<BlockProposal> _proposal, s
     ptr<Header> header = BlockProposal::createBlockProposalHeader(sChain, _proposal);
 
     try {
-        getSchain()->getIo()->writeHeader(socket, header);
+        getSchain()->getIo()->writeRequest(socket, header);
     } catch (ExitRequestedException &) {
         throw;
     } catch (...) {
@@ -257,32 +257,19 @@ void BlockProposalClientAgent::sendBlockProposal(ptr<BlockProposal> _proposal, s
 
         auto mtrh = make_shared<MissingTransactionsResponseHeader>(missingTransactionsSizes);
 
-        try {
-            getSchain()->getIo()->writeHeader(socket, mtrh);
-        } catch (ExitRequestedException &) {
-            throw;
-        } catch (...) {
-            auto errString =
-                    "Proposal: unexpected server disconnect writing missing txs response header";
-            throw_with_nested(new NetworkProtocolException(errString, __CLASS_NAME__));
-        }
-
-
-        LOG(trace, "Proposal step 5: sent missing transactions header");
-
-
         auto mtrm = make_shared<TransactionList>(missingTransactions);
 
         try {
-            getSchain()->getIo()->writeBytesVector(socket->getDescriptor(), mtrm->serialize(false));
+            getSchain()->getIo()->writeHeader(socket, mtrh, mtrm->serialize(false));
         } catch (ExitRequestedException &) {
             throw;
         } catch (...) {
-            auto errString = "Proposal: unexpected server disconnect  writing missing hashes";
+            auto errString =
+                    "Proposal: unexpected server disconnect writing missing transactions";
             throw_with_nested(new NetworkProtocolException(errString, __CLASS_NAME__));
         }
 
-        LOG(trace, "Proposal step 6: sent missing transactions");
+        LOG(trace, "Proposal step 5: sent missing transactions header and transactions");
     }
 
     auto finalHeader = readAndProcessFinalProposalResponseHeader(socket);
@@ -315,7 +302,7 @@ void BlockProposalClientAgent::sendDAProof(
     auto header = make_shared<DAProofRequestHeader>(*getSchain(), _daProof);
 
     try {
-        getSchain()->getIo()->writeHeader(socket, header);
+        getSchain()->getIo()->writeRequest(socket, header);
     } catch (ExitRequestedException &) {
         throw;
     } catch (...) {
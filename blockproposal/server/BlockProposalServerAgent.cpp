@@ -111,7 +111,7 @@ BlockProposalServerAgent::readMissingTransactions(ptr<ServerConnection> connecti
 
     try {
         getSchain()->getIo()->readBytes(connectionEnvelope_, serializedTransactions,
-                                        msg_len(totalSize));
+                                        msg_len(totalSize), NETWORK_BULK_READ_TIMEOUT_MS);
     } catch (ExitRequestedException &) {
         throw;
     } catch (...) {
@@ -158,7 +158,7 @@ BlockProposalServerAgent::getPresentAndMissingTransactions(Schain &_sChain, ptr<
 
 BlockProposalServerAgent::BlockProposalServerAgent(Schain &_schain, ptr<TCPServerSocket> _s) : AbstractServerAgent(
         "BlockPropSrv", _schain, _s) {
-    blockProposalWorkerThreadPool = make_shared<BlockProposalWorkerThreadPool>(num_threads(1), this);
+    blockProposalWorkerThreadPool = make_shared<BlockProposalWorkerThreadPool>(getWorkerThreadCount(_schain), this);
     blockProposalWorkerThreadPool->startService();
     createNetworkReadThread();
 }
@@ -272,8 +272,14 @@ BlockProposalServerAgent::processProposalRequest(ptr<ServerConnection> _connecti
     auto missingTransactionHashes = result.second;
     auto missingHashesRequestHeader = make_shared<MissingTransactionsRequestHeader>(missingTransactionHashes);
 
+    ptr<vector<uint8_t>> serializedMissingHashes = nullptr;
+
+    if (missingTransactionHashes->size() > 0) {
+        serializedMissingHashes = IO::serializePartialHashes(missingTransactionHashes);
+    }
+
     try {
-        send(_connection, missingHashesRequestHeader);
+        send(_connection, missingHashesRequestHeader, serializedMissingHashes);
     } catch (ExitRequestedException &) {
         throw;
     } catch (...) {
@@ -288,15 +294,6 @@ BlockProposalServerAgent::processProposalRequest(ptr<ServerConnection> _connecti
         LOG(debug, "Server: No missing partial hashes");
     } else {
         LOG(debug, "Server: missing partial hashes");
-        try {
-            getSchain()->getIo()->writePartialHashes(_connection->getDescriptor(), missingTransactionHashes);
-        } catch (ExitRequestedException &) {
-            throw;
-        } catch (...) {
-            BOOST_THROW_EXCEPTION(CouldNotSendMessageException(
-                                          "Could not send missing hashes request requestHeader", __CLASS_NAME__ ));
-        }
-
 
         auto missingMessagesResponseHeader = this->readMissingTransactionsResponseHeader(_connection);
 
@@ -634,7 +631,7 @@ ptr<PartialHashesList> AbstractServerAgent::readPartialHashes(ptr<ServerConnecti
             getSchain()->getIo()->readBytes(_connectionEnvelope_,
                                             partialHashesList->getPartialHashes(),
                                             msg_len((uint64_t) partialHashesList->getTransactionCount() *
-                                                    PARTIAL_SHA_HASH_LEN));
+                                                    PARTIAL_SHA_HASH_LEN), NETWORK_BULK_READ_TIMEOUT_MS);
         } catch (ExitRequestedException &) { throw; }
         catch (...) {
             throw_with_nested(
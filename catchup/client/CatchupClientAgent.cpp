@@ -21,6 +21,8 @@
     @date 2018
 */
 
+#include <future>
+
 #include "SkaleCommon.h"
 
 #include "Log.h"
@@ -32,18 +34,22 @@
 #include "abstracttcpserver/ConnectionStatus.h"
 
 #include "network/ClientSocket.h"
+#include "network/ClientSocketPool.h"
 #include "network/IO.h"
 #include "network/TransportNetwork.h"
 #include "chains/Schain.h"
+#include "datastructures/CommittedBlock.h"
 #include "datastructures/CommittedBlockList.h"
 #include "exceptions/NetworkProtocolException.h"
 #include "exceptions/ConnectionRefusedException.h"
 #include "headers/CatchupRequestHeader.h"
 #include "headers/CatchupResponseHeader.h"
 #include "pendingqueue/PendingTransactionsAgent.h"
+#include "utils/Time.h"
 
 #include "CatchupClientAgent.h"
 #include "CatchupClientThreadPool.h"
+#include "CatchupRangeScheduler.h"
 
 
 CatchupClientAgent::CatchupClientAgent( Schain& _sChain ) : Agent(_sChain, false ) {
@@ -67,25 +73,209 @@ nlohmann::json CatchupClientAgent::readCatchupResponseHeader( ptr< ClientSocket
 
 
 void CatchupClientAgent::sync( schain_index _dstIndex ) {
-    LOG( debug, "Catchupc step 0: requesting blocks after " +
-                    to_string( getSchain()->getLastCommittedBlockID() ) );
 
-    auto header = make_shared<CatchupRequestHeader >( *sChain, _dstIndex );
-    auto socket = make_shared<ClientSocket >( *sChain, _dstIndex, CATCHUP );
-    auto io = getSchain()->getIo();
+    auto lastCommitted = getSchain()->getLastCommittedBlockID();
+    auto startTimeMs = Time::getCurrentTimeMs();
+
+    syncChunks( _dstIndex );
+
+    auto applied = ( uint64_t ) getSchain()->getLastCommittedBlockID() - ( uint64_t ) lastCommitted;
+
+    if ( applied == 0 )
+        return;
+
+    auto elapsedMs = max( Time::getCurrentTimeMs() - startTimeMs, ( uint64_t ) 1 );
+
+    catchupBlocksPerSec = applied * 1000 / elapsedMs;
+
+    LOG( info, "Catchup applied " + to_string( applied ) + " blocks at " +
+                   to_string( catchupBlocksPerSec ) + " blocks/s" );
+}
+
+
+void CatchupClientAgent::syncChunks( schain_index _dstIndex ) {
+
+    auto threadCount = max( thread::hardware_concurrency(), 1u );
+
+    nlohmann::json response;
+
+    auto blocks = requestBlocks(
+        _dstIndex, make_shared< CatchupRequestHeader >( *sChain, _dstIndex ), response, threadCount );
+
+    while ( blocks != nullptr ) {
+        auto lastCommitted = getSchain()->getLastCommittedBlockID();
+
+        // older servers do not paginate and send no "more" field
+        bool more = response.find( "more" ) != response.end() && Header::getUint64( response, "more" ) != 0;
+
+        bool parallel = more && getNode()->getCatchupParallelPeers() > 1 && getSchain()->getNodeCount() > 2 &&
+                        response.find( "lastBlockID" ) != response.end();
+
+        // the next chunk is downloaded and verified while this one is committed,
+        // at most one chunk is buffered ahead so memory does not grow with the lag
+        nlohmann::json nextResponse;
+        future< ptr< CommittedBlockList > > nextBlocks;
+
+        if ( more && !parallel ) {
+            block_id lastBlockID = blocks->getBlocks()->back()->getBlockID();
+            nextBlocks = async( launch::async, [this, _dstIndex, lastBlockID, threadCount, &nextResponse]() {
+                return requestBlocks( _dstIndex,
+                    make_shared< CatchupRequestHeader >( *sChain, _dstIndex, lastBlockID, 0 ), nextResponse,
+                    threadCount );
+            } );
+        }
+
+        getSchain()->blockCommitsArrivedThroughCatchup( blocks );
+        LOG( debug, "Catchupc success" );
+
+        if ( !more )
+            return;
+
+        getNode()->exitCheck();
+
+        // no progress, leave the rest to the next sync round
+        if ( getSchain()->getLastCommittedBlockID() <= lastCommitted )
+            return;
+
+        if ( parallel ) {
+            parallelSync( _dstIndex, Header::getUint64( response, "lastBlockID" ) );
+            return;
+        }
+
+        blocks = nextBlocks.get();
+        response = nextResponse;
+    }
+}
+
+
+void CatchupClientAgent::parallelSync( schain_index _firstPeer, block_id _targetBlockID ) {
+
+    auto lastCommitted = getSchain()->getLastCommittedBlockID();
+
+    if ( _targetBlockID <= lastCommitted )
+        return;
+
+    auto peerCount =
+        min( getNode()->getCatchupParallelPeers(), ( uint64_t ) getSchain()->getNodeCount() - 1 );
+
+    CatchupRangeScheduler scheduler( lastCommitted + 1, _targetBlockID,
+        getNode()->getMaxCatchupResponseBlocks(), 2 * peerCount, CATCHUP_STRAGGLER_MS );
+
+    LOG( info, "Parallel catchup from " + to_string( peerCount ) + " peers up to block " +
+                   to_string( _targetBlockID ) );
+
+    vector< thread > workers;
+
+    auto peer = _firstPeer;
+
+    for ( uint64_t i = 0; i < peerCount; i++ ) {
+        workers.emplace_back( parallelSyncWorkerLoop, this, &scheduler, peer );
+        peer = nextSyncNodeIndex( this, peer );
+    }
 
+    auto lastProgressMs = Time::getCurrentTimeMs();
 
     try {
-        io->writeMagic( socket );
-    } catch ( ExitRequestedException& ) {
-        throw;
+        // ranges arrive out of order, they are committed strictly in block order
+        while ( !scheduler.isFinished() ) {
+            getNode()->exitCheck();
+
+            auto blocks = scheduler.nextInOrder( 100 );
+
+            if ( blocks != nullptr ) {
+                getSchain()->blockCommitsArrivedThroughCatchup( blocks );
+                lastProgressMs = Time::getCurrentTimeMs();
+            } else if ( Time::getCurrentTimeMs() - lastProgressMs > NETWORK_BULK_READ_TIMEOUT_MS ) {
+                LOG( info, "Parallel catchup stalled, leaving the rest to the next sync round" );
+                break;
+            }
+
+            scheduler.blocksCommitted( getSchain()->getLastCommittedBlockID() );
+        }
     } catch ( ... ) {
-        throw_with_nested( NetworkProtocolException(
-            "Catchupc: Server disconnect sending magic", __CLASS_NAME__ ) );
+        scheduler.cancel();
+        for ( auto&& worker : workers )
+            worker.join();
+        throw;
+    }
+
+    scheduler.cancel();
+
+    for ( auto&& worker : workers )
+        worker.join();
+}
+
+
+void CatchupClientAgent::parallelSyncWorkerLoop(
+    CatchupClientAgent* agent, CatchupRangeScheduler* _scheduler, schain_index _peer ) {
+
+    setThreadName( "CatchupRange", agent->getNode()->getConsensusEngine() );
+
+    // the cores are shared between the concurrent downloads
+    auto threadCount =
+        max( thread::hardware_concurrency() / agent->getNode()->getCatchupParallelPeers(), ( uint64_t ) 1 );
+
+    block_id from = 0;
+    block_id to = 0;
+
+    try {
+        while ( _scheduler->takeRange( from, to ) ) {
+            try {
+                nlohmann::json response;
+
+                auto blocks = agent->requestBlocks( _peer,
+                    make_shared< CatchupRequestHeader >( *agent->sChain, _peer, from - 1, to ), response,
+                    threadCount );
+
+                if ( blocks != nullptr && !blocks->getBlocks()->empty() &&
+                     blocks->getBlocks()->front()->getBlockID() == from ) {
+                    _scheduler->rangeDownloaded( from, to, blocks );
+                    continue;
+                }
+
+                // the peer is behind, it does not have this range
+                _scheduler->rangeFailed( from, to );
+            } catch ( ExitRequestedException& ) {
+                _scheduler->cancel();
+                return;
+            } catch ( ConnectionRefusedException& e ) {
+                _scheduler->rangeFailed( from, to );
+                agent->logConnectionRefused( e, _peer );
+            } catch ( exception& e ) {
+                _scheduler->rangeFailed( from, to );
+                Exception::logNested( e );
+            }
+
+            // move to another peer, the failed range is picked up by the next free worker
+            _peer = nextSyncNodeIndex( agent, _peer );
+            usleep( agent->getNode()->getWaitAfterNetworkErrorMs() * 1000 );
+        }
+    } catch ( FatalError* e ) {
+        _scheduler->cancel();
+        agent->getNode()->exitOnFatalError( e->getMessage() );
+    } catch ( exception& e ) {
+        _scheduler->cancel();
+        Exception::logNested( e );
     }
+}
+
+
+uint64_t CatchupClientAgent::getCatchupBlocksPerSec() const {
+    return catchupBlocksPerSec;
+}
+
+
+ptr< CommittedBlockList > CatchupClientAgent::requestBlocks(
+    schain_index _dstIndex, ptr< CatchupRequestHeader > _header, nlohmann::json& _response,
+    uint64_t _threadCount ) {
+    LOG( debug, "Catchupc step 0: requesting blocks" );
+
+    auto socket = sChain->getClientSocketPool()->acquire( _dstIndex, CATCHUP );
+    auto io = getSchain()->getIo();
+
 
     try {
-        io->writeHeader( socket, header );
+        io->writeRequest( socket, _header );
     } catch ( ExitRequestedException& ) {
         throw;
     } catch ( ... ) {
@@ -95,10 +285,8 @@ void CatchupClientAgent::sync( schain_index _dstIndex ) {
     }
     LOG( debug, "Catchupc step 1: wrote catchup request" );
 
-    nlohmann::json response;
-
     try {
-        response = readCatchupResponseHeader( socket );
+        _response = readCatchupResponseHeader( socket );
     } catch ( ExitRequestedException& ) {
         throw;
     } catch ( ... ) {
@@ -110,11 +298,12 @@ void CatchupClientAgent::sync( schain_index _dstIndex ) {
 
     LOG( debug, "Catchupc step 2: read catchup response header" );
 
-    auto status = ( ConnectionStatus ) Header::getUint64( response, "status" );
+    auto status = ( ConnectionStatus ) Header::getUint64( _response, "status" );
 
     if ( status == CONNECTION_DISCONNECT ) {
         LOG( debug, "Catchupc got response::no missing blocks" );
-        return;
+        sChain->getClientSocketPool()->release( socket );
+        return nullptr;
     }
 
 
@@ -128,7 +317,7 @@ void CatchupClientAgent::sync( schain_index _dstIndex ) {
 
 
     try {
-        blocks = readMissingBlocks( socket, response );
+        blocks = readMissingBlocks( socket, _response, _threadCount );
     } catch ( ExitRequestedException& ) {
         throw;
     } catch ( ... ) {
@@ -139,8 +328,9 @@ void CatchupClientAgent::sync( schain_index _dstIndex ) {
 
     LOG( debug, "Catchupc step 3: got missing blocks:" + to_string( blocks->getBlocks()->size() ) );
 
-    getSchain()->blockCommitsArrivedThroughCatchup( blocks );
-    LOG( debug, "Catchupc success" );
+    sChain->getClientSocketPool()->release( socket );
+
+    return blocks;
 }
 
 size_t CatchupClientAgent::parseBlockSizes(
@@ -179,7 +369,7 @@ size_t CatchupClientAgent::parseBlockSizes(
 
 
 ptr< CommittedBlockList > CatchupClientAgent::readMissingBlocks(
-    ptr< ClientSocket > _socket, nlohmann::json responseHeader ) {
+    ptr< ClientSocket > _socket, nlohmann::json responseHeader, uint64_t _threadCount ) {
     ASSERT( responseHeader > 0 );
 
     auto blockSizes = make_shared<vector< uint64_t > >();
@@ -190,7 +380,7 @@ ptr< CommittedBlockList > CatchupClientAgent::readMissingBlocks(
 
     try {
         getSchain()->getIo()->readBytes(_socket->getDescriptor(),
-                                        serializedBlocks, msg_len(totalSize));
+                                        serializedBlocks, msg_len(totalSize), NETWORK_BULK_READ_TIMEOUT_MS);
     } catch ( ExitRequestedException& ) {
         throw;
     } catch ( ... ) {
@@ -206,7 +396,8 @@ ptr< CommittedBlockList > CatchupClientAgent::readMissingBlocks(
     ptr< CommittedBlockList > blockList = nullptr;
 
     try {
-        blockList = CommittedBlockList::deserialize(getSchain()->getCryptoManager(),  blockSizes, serializedBlocks, 0);
+        blockList = CommittedBlockList::deserialize(getSchain()->getCryptoManager(),  blockSizes, serializedBlocks, 0,
+                                                    _threadCount);
     } catch ( ExitRequestedException& ) {
         throw;
     } catch ( ... ) {
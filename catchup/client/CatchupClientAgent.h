@@ -29,6 +29,8 @@ class ClientSocket;
 class Schain;
 class CatchupClientThreadPool;
 class CatchupResponseHeader;
+class CatchupRequestHeader;
+class CatchupRangeScheduler;
 
 class CatchupClientAgent : public Agent {
 
@@ -36,20 +38,39 @@ public:
 
     ptr< CatchupClientThreadPool > catchupClientThreadPool = nullptr;
 
+    atomic< uint64_t > catchupBlocksPerSec = 0;
+
 
     CatchupClientAgent( Schain& _sChain );
 
 
+    // downloads missing blocks and updates the catchup rate
     void sync( schain_index _dstIndex );
 
+    void syncChunks( schain_index _dstIndex );
+
+    // nullptr if the peer has no blocks after the requested one
+    ptr< CommittedBlockList > requestBlocks( schain_index _dstIndex, ptr< CatchupRequestHeader > _header,
+        nlohmann::json& _response, uint64_t _threadCount = 1 );
+
+    // splits the missing blocks into ranges downloaded from several peers at once
+    void parallelSync( schain_index _firstPeer, block_id _targetBlockID );
+
+    static void parallelSyncWorkerLoop(
+        CatchupClientAgent* agent, CatchupRangeScheduler* _scheduler, schain_index _peer );
+
+    // blocks per second applied by the last sync round that committed anything
+    uint64_t getCatchupBlocksPerSec() const;
+
 
     static void workerThreadItemSendLoop( CatchupClientAgent* agent );
 
     nlohmann::json readCatchupResponseHeader( ptr< ClientSocket > _socket );
 
 
+    // blocks are parsed and verified on _threadCount threads
     ptr< CommittedBlockList > readMissingBlocks(
-        ptr< ClientSocket > _socket, nlohmann::json responseHeader );
+        ptr< ClientSocket > _socket, nlohmann::json responseHeader, uint64_t _threadCount = 1 );
 
 
     size_t parseBlockSizes( nlohmann::json _responseHeader, ptr< vector< uint64_t > > _blockSizes );
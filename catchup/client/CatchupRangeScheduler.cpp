@@ -0,0 +1,200 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file CatchupRangeScheduler.cpp
+    @author Stan Kladko
+    @date 2019
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/InvalidStateException.h"
+
+#include "datastructures/CommittedBlock.h"
+#include "datastructures/CommittedBlockList.h"
+#include "utils/Time.h"
+
+#include "CatchupRangeScheduler.h"
+
+
+CatchupRangeScheduler::CatchupRangeScheduler(block_id _firstBlockID, block_id _targetBlockID, uint64_t _rangeSize,
+                                             uint64_t _maxBufferedRanges, uint64_t _stragglerMs)
+        : nextBlockID(_firstBlockID), targetBlockID(_targetBlockID), rangeSize(_rangeSize),
+          stragglerMs(_stragglerMs) {
+
+    CHECK_ARGUMENT(_rangeSize > 0);
+    CHECK_ARGUMENT(_maxBufferedRanges > 0);
+
+    windowBlocks = _rangeSize * _maxBufferedRanges;
+
+    for (uint64_t from = (uint64_t) _firstBlockID; from <= (uint64_t) _targetBlockID; from += _rangeSize) {
+        pending[from] = min(from + _rangeSize - 1, (uint64_t) _targetBlockID);
+    }
+}
+
+
+bool CatchupRangeScheduler::isFinishedLocked() {
+    return cancelled || nextBlockID > targetBlockID;
+}
+
+
+bool CatchupRangeScheduler::isFinished() {
+    lock_guard<mutex> lock(rangesMutex);
+    return isFinishedLocked();
+}
+
+
+void CatchupRangeScheduler::reassignStragglers(uint64_t _nowMs) {
+    for (auto &&item : inFlight) {
+        if (item.first >= nextBlockID + windowBlocks)
+            break;
+        if (_nowMs - item.second.second > stragglerMs && pending.count(item.first) == 0) {
+            // a second peer races the slow one, whichever answers first wins
+            pending[item.first] = item.second.first;
+            item.second.second = _nowMs;
+        }
+    }
+}
+
+
+bool CatchupRangeScheduler::takeRange(block_id &_from, block_id &_to) {
+
+    unique_lock<mutex> lock(rangesMutex);
+
+    while (!isFinishedLocked()) {
+
+        reassignStragglers(Time::getCurrentTimeMs());
+
+        while (!pending.empty() && pending.begin()->second < nextBlockID) {
+            pending.erase(pending.begin());
+        }
+
+        if (!pending.empty() && pending.begin()->first < nextBlockID + windowBlocks) {
+            auto range = *pending.begin();
+            pending.erase(pending.begin());
+
+            _from = max(range.first, nextBlockID);
+            _to = range.second;
+
+            if (inFlight.count(_from) == 0)
+                inFlight[_from] = {_to, Time::getCurrentTimeMs()};
+
+            return true;
+        }
+
+        rangesCond.wait_for(lock, chrono::milliseconds(100));
+    }
+
+    return false;
+}
+
+
+void CatchupRangeScheduler::rangeDownloaded(block_id _from, block_id _to, ptr<CommittedBlockList> _blocks) {
+
+    CHECK_ARGUMENT(_blocks != nullptr);
+
+    auto blocks = _blocks->getBlocks();
+
+    CHECK_ARGUMENT(!blocks->empty());
+    CHECK_ARGUMENT(blocks->front()->getBlockID() == _from);
+
+    {
+        lock_guard<mutex> lock(rangesMutex);
+
+        inFlight.erase(_from);
+
+        auto end = (uint64_t) _from + blocks->size();
+
+        if (end <= (uint64_t) _to && pending.count(end) == 0 && inFlight.count(end) == 0)
+            pending[end] = _to;
+
+        if (end > nextBlockID && completed.count(_from) == 0)
+            completed[_from] = _blocks;
+    }
+
+    rangesCond.notify_all();
+}
+
+
+void CatchupRangeScheduler::rangeFailed(block_id _from, block_id _to) {
+
+    {
+        lock_guard<mutex> lock(rangesMutex);
+
+        if (completed.count(_from) == 0 && _to >= nextBlockID) {
+            inFlight.erase(_from);
+            pending[_from] = _to;
+        }
+    }
+
+    rangesCond.notify_all();
+}
+
+
+ptr<CommittedBlockList> CatchupRangeScheduler::nextInOrder(uint64_t _waitMs) {
+
+    unique_lock<mutex> lock(rangesMutex);
+
+    auto deadline = chrono::steady_clock::now() + chrono::milliseconds(_waitMs);
+
+    while (!isFinishedLocked()) {
+
+        while (!completed.empty()) {
+            auto first = completed.begin();
+            if (first->first > nextBlockID)
+                break;
+            auto blocks = first->second;
+            completed.erase(first);
+            // skip lists that were already committed through another peer or consensus
+            if ((uint64_t) blocks->getBlocks()->back()->getBlockID() >= (uint64_t) nextBlockID)
+                return blocks;
+        }
+
+        if (rangesCond.wait_until(lock, deadline) == cv_status::timeout)
+            return nullptr;
+    }
+
+    return nullptr;
+}
+
+
+void CatchupRangeScheduler::blocksCommitted(block_id _lastCommittedBlockID) {
+
+    {
+        lock_guard<mutex> lock(rangesMutex);
+
+        if (_lastCommittedBlockID >= nextBlockID)
+            nextBlockID = _lastCommittedBlockID + 1;
+
+        while (!inFlight.empty() && inFlight.begin()->second.first < nextBlockID) {
+            inFlight.erase(inFlight.begin());
+        }
+    }
+
+    // the window moved, workers may take further ranges
+    rangesCond.notify_all();
+}
+
+
+void CatchupRangeScheduler::cancel() {
+    {
+        lock_guard<mutex> lock(rangesMutex);
+        cancelled = true;
+    }
+    rangesCond.notify_all();
+}
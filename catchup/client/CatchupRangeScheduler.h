@@ -0,0 +1,81 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file CatchupRangeScheduler.h
+    @author Stan Kladko
+    @date 2019
+*/
+
+#pragma once
+
+class CommittedBlockList;
+
+// hands out block ranges to parallel catchup workers and returns downloaded ranges in block order
+class CatchupRangeScheduler {
+
+    mutex rangesMutex;
+
+    condition_variable rangesCond;
+
+    // first block that has not been committed yet
+    block_id nextBlockID;
+
+    block_id targetBlockID;
+
+    uint64_t rangeSize;
+
+    // ranges starting further ahead than this are not handed out, which bounds buffered blocks
+    uint64_t windowBlocks;
+
+    uint64_t stragglerMs;
+
+    bool cancelled = false;
+
+    map<block_id, block_id> pending;
+
+    // start of range -> (end of range, time it was handed out)
+    map<block_id, pair<block_id, uint64_t>> inFlight;
+
+    map<block_id, ptr<CommittedBlockList>> completed;
+
+    void reassignStragglers(uint64_t _nowMs);
+
+    bool isFinishedLocked();
+
+public:
+
+    CatchupRangeScheduler(block_id _firstBlockID, block_id _targetBlockID, uint64_t _rangeSize,
+                          uint64_t _maxBufferedRanges, uint64_t _stragglerMs);
+
+    // waits for a range to download, returns false once catchup is finished or cancelled
+    bool takeRange(block_id &_from, block_id &_to);
+
+    // a short list means the server capped its response, the remainder goes back to the queue
+    void rangeDownloaded(block_id _from, block_id _to, ptr<CommittedBlockList> _blocks);
+
+    void rangeFailed(block_id _from, block_id _to);
+
+    // next list that can be applied on top of the chain, nullptr if none arrived within _waitMs
+    ptr<CommittedBlockList> nextInOrder(uint64_t _waitMs);
+
+    void blocksCommitted(block_id _lastCommittedBlockID);
+
+    bool isFinished();
+
+    void cancel();
+};
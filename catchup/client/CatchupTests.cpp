@@ -0,0 +1,182 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file CatchupTests.cpp
+    @author Stan Kladko
+    @date 2019
+*/
+
+
+#include <future>
+
+#include "SkaleCommon.h"
+#include "crypto/CryptoManager.h"
+#include "datastructures/CommittedBlock.h"
+#include "datastructures/CommittedBlockList.h"
+
+#define BOOST_PENDING_INTEGER_LOG2_HPP
+
+#include <boost/integer/integer_log2.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+
+#include "thirdparty/catch.hpp"
+
+
+#include "chains/Schain.h"
+
+#include "CatchupRangeScheduler.h"
+
+
+ptr<CommittedBlockList> create_block_list(ptr<CryptoManager> _cryptoManager, uint64_t _from, uint64_t _to) {
+
+    boost::random::mt19937 gen;
+    boost::random::uniform_int_distribution<> ubyte(0, 255);
+
+    auto blocks = make_shared<vector<ptr<CommittedBlock>>>();
+
+    for (uint64_t i = _from; i <= _to; i++) {
+        blocks->push_back(CommittedBlock::createRandomSample(_cryptoManager, 1, gen, ubyte, block_id(i)));
+    }
+
+    return make_shared<CommittedBlockList>(blocks);
+}
+
+uint64_t first_block(const ptr<CommittedBlockList> &_list) {
+    REQUIRE(_list != nullptr);
+    return (uint64_t) _list->getBlocks()->front()->getBlockID();
+}
+
+
+void test_catchup_scheduler_order() {
+
+    Schain chain;
+    auto cryptoManager = make_shared<CryptoManager>(chain);
+
+    // ranges [1,3] [4,6] [7,9] [10,10], two of them may be ahead of the chain
+    CatchupRangeScheduler scheduler(1, 10, 3, 2, 1000000);
+
+    block_id from = 0;
+    block_id to = 0;
+
+    REQUIRE(scheduler.takeRange(from, to));
+    REQUIRE((from == 1 && to == 3));
+    REQUIRE(scheduler.takeRange(from, to));
+    REQUIRE((from == 4 && to == 6));
+
+    // the second range arrives first and has to wait for the first one
+    scheduler.rangeDownloaded(4, 6, create_block_list(cryptoManager, 4, 6));
+    REQUIRE(scheduler.nextInOrder(0) == nullptr);
+
+    scheduler.rangeDownloaded(1, 3, create_block_list(cryptoManager, 1, 3));
+    REQUIRE(first_block(scheduler.nextInOrder(0)) == 1);
+    REQUIRE(scheduler.nextInOrder(0) == nullptr);
+
+    // the window is full until the first range is committed
+    block_id windowFrom = 0;
+    block_id windowTo = 0;
+    auto taken = async(launch::async, [&scheduler, &windowFrom, &windowTo]() {
+        return scheduler.takeRange(windowFrom, windowTo);
+    });
+    REQUIRE(taken.wait_for(chrono::milliseconds(300)) == future_status::timeout);
+
+    scheduler.blocksCommitted(3);
+
+    REQUIRE(taken.get());
+    REQUIRE((windowFrom == 7 && windowTo == 9));
+    REQUIRE(first_block(scheduler.nextInOrder(0)) == 4);
+
+    scheduler.blocksCommitted(6);
+
+    // a capped response re-queues the rest of the range at its end
+    scheduler.rangeDownloaded(7, 9, create_block_list(cryptoManager, 7, 7));
+
+    REQUIRE(scheduler.takeRange(from, to));
+    REQUIRE((from == 8 && to == 9));
+    REQUIRE(scheduler.takeRange(from, to));
+    REQUIRE((from == 10 && to == 10));
+
+    REQUIRE(first_block(scheduler.nextInOrder(0)) == 7);
+    scheduler.blocksCommitted(7);
+
+    scheduler.rangeDownloaded(10, 10, create_block_list(cryptoManager, 10, 10));
+    REQUIRE(scheduler.nextInOrder(0) == nullptr);
+
+    scheduler.rangeDownloaded(8, 9, create_block_list(cryptoManager, 8, 9));
+    REQUIRE(first_block(scheduler.nextInOrder(0)) == 8);
+    scheduler.blocksCommitted(9);
+    REQUIRE(first_block(scheduler.nextInOrder(0)) == 10);
+    scheduler.blocksCommitted(10);
+
+    REQUIRE(scheduler.isFinished());
+    REQUIRE(!scheduler.takeRange(from, to));
+}
+
+
+void test_catchup_scheduler_stragglers() {
+
+    Schain chain;
+    auto cryptoManager = make_shared<CryptoManager>(chain);
+
+    CatchupRangeScheduler scheduler(1, 2, 1, 2, 50);
+
+    block_id from = 0;
+    block_id to = 0;
+
+    REQUIRE(scheduler.takeRange(from, to));
+    REQUIRE((from == 1 && to == 1));
+    REQUIRE(scheduler.takeRange(from, to));
+    REQUIRE((from == 2 && to == 2));
+
+    usleep(100 * 1000);
+
+    // both ranges are overdue, so a free worker races the slow peer
+    REQUIRE(scheduler.takeRange(from, to));
+    REQUIRE((from == 1 && to == 1));
+
+    scheduler.rangeDownloaded(1, 1, create_block_list(cryptoManager, 1, 1));
+    REQUIRE(first_block(scheduler.nextInOrder(0)) == 1);
+    scheduler.blocksCommitted(1);
+
+    // the slow peer answers late, its copy is dropped
+    scheduler.rangeDownloaded(1, 1, create_block_list(cryptoManager, 1, 1));
+    REQUIRE(scheduler.nextInOrder(0) == nullptr);
+
+    // a failed range goes back to the queue
+    scheduler.rangeFailed(2, 2);
+    REQUIRE(scheduler.takeRange(from, to));
+    REQUIRE((from == 2 && to == 2));
+
+    scheduler.rangeDownloaded(2, 2, create_block_list(cryptoManager, 2, 2));
+    REQUIRE(first_block(scheduler.nextInOrder(0)) == 2);
+    scheduler.blocksCommitted(2);
+
+    REQUIRE(scheduler.isFinished());
+}
+
+
+TEST_CASE("Schedule parallel catchup ranges", "[catchup-range-scheduler]") {
+    SECTION("Test in order delivery and window movement")
+
+        test_catchup_scheduler_order();
+
+    SECTION("Test straggler reassignment")
+
+        test_catchup_scheduler_stragglers();
+}
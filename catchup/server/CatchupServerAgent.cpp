@@ -80,7 +80,7 @@ CatchupWorkerThreadPool *CatchupServerAgent::getCatchupWorkerThreadPool() const
 
 CatchupServerAgent::CatchupServerAgent(Schain &_schain, ptr<TCPServerSocket> _s) : AbstractServerAgent(
         "CatchupServer", _schain, _s) {
-    catchupWorkerThreadPool = make_shared<CatchupWorkerThreadPool>(num_threads(1), this);
+    catchupWorkerThreadPool = make_shared<CatchupWorkerThreadPool>(getWorkerThreadCount(_schain), this);
     catchupWorkerThreadPool->startService();
     createNetworkReadThread();
 }
@@ -150,7 +150,7 @@ void CatchupServerAgent::processNextAvailableConnection(ptr<ServerConnection> _c
 
 
     try {
-        send(_connection, responseHeader);
+        send(_connection, responseHeader, serializedBinary);
     }
     catch (ExitRequestedException &) {
         throw;
@@ -160,27 +160,12 @@ void CatchupServerAgent::processNextAvailableConnection(ptr<ServerConnection> _c
     }
 
 
-    LOG(debug, "Server step 2: sent catchup response header");
-
-
     if (serializedBinary == nullptr) {
-        LOG(debug, "Server step 3: response completed: no blocks sent");
-        return;
-    }
-
-    try {
-        getSchain()->getIo()->writeBytesVector(_connection->getDescriptor(), serializedBinary);
-    } catch (ExitRequestedException &) {
-        throw;
-    }
-    catch (...) {
-        throw_with_nested(CouldNotSendMessageException("Could not send serialized binary", __CLASS_NAME__));
+        LOG(debug, "Server step 2: response completed: no blocks sent");
+    } else {
+        LOG(debug, "Server step 2: response completed: blocks sent");
     }
 
-    LOG(debug, "Server step 3: response completed: blocks sent");
-
-    return;
-
 
 }
 
@@ -239,7 +224,7 @@ ptr<vector<uint8_t>> CatchupServerAgent::createResponseHeaderAndBinary(ptr<Serve
 }
 
 
-ptr<vector<uint8_t>> CatchupServerAgent::createBlockCatchupResponse(nlohmann::json /*_jsonRequest */,
+ptr<vector<uint8_t>> CatchupServerAgent::createBlockCatchupResponse(nlohmann::json _jsonRequest,
                                                                     ptr<CatchupResponseHeader> _responseHeader,
                                                                     block_id _blockID) {
 
@@ -259,6 +244,15 @@ ptr<vector<uint8_t>> CatchupServerAgent::createBlockCatchupResponse(nlohmann::js
 
         auto committedBlockID = sChain->getLastCommittedBlockID();
 
+        _responseHeader->setLastBlockID(committedBlockID);
+
+        // parallel catchup clients ask each peer for a bounded range
+        if (_jsonRequest.find("toBlockID") != _jsonRequest.end()) {
+            block_id toBlockID = Header::getUint64(_jsonRequest, "toBlockID");
+            if (toBlockID < committedBlockID)
+                committedBlockID = toBlockID;
+        }
+
         if (_blockID >= committedBlockID) {
             LOG(debug, "Catchups: blockID >= committedBlockID");
             _responseHeader->setStatus(CONNECTION_DISCONNECT);
@@ -271,19 +265,31 @@ ptr<vector<uint8_t>> CatchupServerAgent::createBlockCatchupResponse(nlohmann::js
         serializedBlocks->push_back('[');
 
 
-        for (uint64_t i = (uint64_t) _blockID + 1; i <= committedBlockID; i++) {
+        auto blockDB = getSchain()->getNode()->getBlockDB();
+
+        auto maxBytes = getNode()->getMaxCatchupResponseBytes();
+        auto maxBlocks = getNode()->getMaxCatchupResponseBlocks();
 
-            auto serializedBlock = getSchain()->getNode()->getBlockDB()->getSerializedBlockFromLevelDB(i);
+        uint64_t i = (uint64_t) _blockID + 1;
 
-            if (!serializedBlock) {
+        // the response is bounded, the client comes back for the rest on the same connection
+        for (; i <= committedBlockID; i++) {
+
+            if (!blockSizes->empty() &&
+                (blockSizes->size() >= maxBlocks || serializedBlocks->size() >= maxBytes)) {
+                break;
+            }
+
+            auto start = serializedBlocks->size();
+
+            // blocks are copied from LevelDB straight into the response
+            if (!blockDB->appendSerializedBlock(i, *serializedBlocks)) {
                 _responseHeader->setStatus(CONNECTION_DISCONNECT);
                 _responseHeader->setComplete();
                 return nullptr;
             }
 
-            serializedBlocks->insert(serializedBlocks->end(), serializedBlock->begin(), serializedBlock->end());
-
-            blockSizes->push_back(serializedBlock->size());
+            blockSizes->push_back(serializedBlocks->size() - start);
 
         }
 
@@ -291,6 +297,8 @@ ptr<vector<uint8_t>> CatchupServerAgent::createBlockCatchupResponse(nlohmann::js
 
         _responseHeader->setStatus(CONNECTION_PROCEED);
 
+        _responseHeader->setMore(i <= committedBlockID);
+
         _responseHeader->setBlockSizes(blockSizes);
 
         return serializedBlocks;
@@ -346,9 +354,18 @@ ptr<vector<uint8_t>> CatchupServerAgent::createBlockFinalizeResponse(nlohmann::j
             return nullptr;
         }
 
-        auto fragment = proposal->getFragment(
-                (uint64_t) getSchain()->getNodeCount() - 1,
-                fragmentIndex);
+        // older clients do not send the flag and get plain slices
+        bool erasureCoded = _jsonRequest.find("erasureCoded") != _jsonRequest.end() &&
+                            _jsonRequest["erasureCoded"].get<bool>();
+
+        ptr<BlockProposalFragment> fragment;
+
+        if (erasureCoded) {
+            fragment = proposal->getErasureCodedFragment((uint64_t) getSchain()->getNodeCount() - 1,
+                                                         fragmentIndex);
+        } else {
+            fragment = proposal->getFragment((uint64_t) getSchain()->getNodeCount() - 1, fragmentIndex);
+        }
 
         CHECK_STATE(fragment != nullptr);
 
@@ -356,6 +373,10 @@ ptr<vector<uint8_t>> CatchupServerAgent::createBlockFinalizeResponse(nlohmann::j
 
         auto serializedFragment = fragment->serialize();
 
+        if (erasureCoded) {
+            _responseHeader->setErasureParams(fragment->getDataFragments(), fragment->getFragmentHashes());
+        }
+
         _responseHeader->setFragmentParams(serializedFragment->size(),
                                            proposal->serialize()->size(), proposal->getHash()->toHex());
 
@@ -44,6 +44,7 @@
 #include "network/TransportNetwork.h"
 
 #include "blockfinalize/client/BlockFinalizeDownloader.h"
+#include "blockfinalize/client/BlockFinalizeDownloadAgent.h"
 #include "blockproposal/server/BlockProposalServerAgent.h"
 #include "datastructures/BooleanProposalVector.h"
 #include "catchup/client/CatchupClientAgent.h"
@@ -59,6 +60,7 @@
 #include "messages/NetworkMessageEnvelope.h"
 #include "node/NodeInfo.h"
 #include "db/BlockProposalDB.h"
+#include "db/ConsensusStateDB.h"
 #include "db/DAProofDB.h"
 #include "db/DASigShareDB.h"
 #include "db/ProposalVectorDB.h"
@@ -66,6 +68,7 @@
 #include "protocols/ProtocolInstance.h"
 #include "protocols/blockconsensus/BlockConsensusAgent.h"
 #include "network/ClientSocket.h"
+#include "network/ClientSocketPool.h"
 #include "network/IO.h"
 #include "network/ZMQServerSocket.h"
 #include "crypto/SHAHash.h"
@@ -151,6 +154,18 @@ void Schain::messageThreadProcessingLoop(Schain *s) {
             }
 
 
+            // consensus state changes made while processing the queue are written as one batch
+
+            auto consensusStateDB = s->getNode()->getConsensusStateDB();
+
+            consensusStateDB->startBatch();
+
+            // broadcasts made while processing the queue go out as one frame per peer
+
+            auto network = s->getNode()->getNetwork();
+
+            network->startSendBatch();
+
             while (!newQueue.empty()) {
                 ptr<MessageEnvelope> m = newQueue.front();
                 ASSERT((uint64_t) m->getMessage()->getBlockId() != 0);
@@ -167,6 +182,10 @@ void Schain::messageThreadProcessingLoop(Schain *s) {
 
                 newQueue.pop();
             }
+
+            consensusStateDB->commitBatch();
+
+            network->commitSendBatch();
         }
 
 
@@ -199,6 +218,8 @@ Schain::Schain(weak_ptr<Node> _node, schain_index _schainIndex, const schain_id
 
         this->io = make_shared<IO>(this);
 
+        this->clientSocketPool = make_shared<ClientSocketPool>(this);
+
         ASSERT(getNode()->getNodeInfosByIndex()->size() > 0);
 
         for (auto const &iterator : *getNode()->getNodeInfosByIndex()) {
@@ -243,6 +264,7 @@ void Schain::constructChildAgents() {
         pendingTransactionsAgent = make_shared<PendingTransactionsAgent>(*this);
         blockProposalClient = make_shared<BlockProposalClientAgent>(*this);
         catchupClientAgent = make_shared<CatchupClientAgent>(*this);
+        blockFinalizeDownloadAgent = make_shared<BlockFinalizeDownloadAgent>(*this);
 
 
         testMessageGeneratorAgent = make_shared<TestMessageGeneratorAgent>(*this);
@@ -416,7 +438,12 @@ void Schain::processCommittedBlock(ptr<CommittedBlock> _block) {
             ":BPS:" +
             to_string(BlockProposalSet::getTotalObjects()) +
             ":HDRS:" + to_string(Header::getTotalObjects()) + ":SOCK:" + to_string(ClientSocket::getTotalSockets()) +
-            ":CONS:" + to_string(ServerConnection::getTotalObjects()));
+            ":CONS:" + to_string(ServerConnection::getTotalObjects()) +
+            ":PCH:" + to_string(getNode()->getBlockProposalDB()->getCacheHits()) +
+            ":PCM:" + to_string(getNode()->getBlockProposalDB()->getCacheMisses()) +
+            ":SQD:" + to_string(getNode()->getNetwork()->getTotalSendQueueDepth()) +
+            ":DSB:" + to_string(getNode()->getNetwork()->getTotalDelayedSendsBacklog()) +
+            ":CBPS:" + to_string(catchupClientAgent != nullptr ? catchupClientAgent->getCatchupBlocksPerSec() : 0));
 
 
         saveBlock(_block);
@@ -426,6 +453,11 @@ void Schain::processCommittedBlock(ptr<CommittedBlock> _block) {
         lastCommittedBlockID++;
         lastCommitTime = Time::getCurrentTimeMs();
 
+        getNode()->getNetwork()->notifyBlockCommitted();
+
+        if (blockFinalizeDownloadAgent != nullptr)
+            blockFinalizeDownloadAgent->cancelDownloads(getLastCommittedBlockID());
+
     } catch (ExitRequestedException &e) { throw; }
     catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
@@ -803,19 +835,15 @@ void Schain::decideBlock(block_id _blockId, schain_index _proposerIndex, ptr<Thr
             // Note that due to the BLS signature proof, 2t hosts out of 3t + 1 total are guaranteed to
             // posess the proposal
 
-            auto agent = make_unique<BlockFinalizeDownloader>(this, _blockId, _proposerIndex);
-
-            {
-                const string message = "Finalization download:" + to_string(_blockId) + ":" +
-                                       to_string(_proposerIndex);
-
-                MONITOR(__CLASS_NAME__, message.c_str());
-                // This will complete successfully also if block arrives through catchup
-                proposal = agent->downloadProposal();
+            if (getNodeCount() > 1) {
+                // the download agent commits the block once it arrives, or drops it if catchup is first
+                blockFinalizeDownloadAgent->startDownload(_blockId, _proposerIndex, _thresholdSig);
+                return;
             }
 
-            if (proposal != nullptr) // Nullptr means catchup happened first
-                getNode()->getBlockProposalDB()->addBlockProposal(proposal);
+            // a single node chain has no peers to download from, and can only decide its own proposal
+            CHECK_STATE2(proposal != nullptr,
+                         "No local proposal for decided block " + to_string(_blockId));
         }
 
         if (proposal != nullptr)
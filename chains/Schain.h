@@ -43,7 +43,7 @@ class BlockProposalClientAgent;
 class BlockProposalPusherThreadPool;
 
 class BlockFinalizeDownloader;
-class BlockFinalizeDownloaderThreadPool;
+class BlockFinalizeDownloadAgent;
 
 class SchainMessageThreadPool;
 
@@ -66,6 +66,7 @@ class BlockConsensusAgent;
 class PricingAgent;
 class IO;
 class Sockets;
+class ClientSocketPool;
 
 
 class SHAHash;
@@ -102,6 +103,8 @@ class Schain : public Agent {
 
     ptr<CatchupClientAgent> catchupClientAgent = nullptr;
 
+    ptr<BlockFinalizeDownloadAgent> blockFinalizeDownloadAgent = nullptr;
+
     ptr<PricingAgent> pricingAgent = nullptr;
 
     ptr<SchainMessageThreadPool> consensusMessageThreadPool = nullptr;
@@ -110,6 +113,8 @@ class Schain : public Agent {
 
     ptr<IO> io;
 
+    ptr<ClientSocketPool> clientSocketPool;
+
     ptr<CryptoManager> cryptoManager;
 
     weak_ptr<Node> node;
@@ -201,6 +206,10 @@ public:
 
     const ptr<IO> getIo() const;
 
+    ptr<ClientSocketPool> getClientSocketPool() const;
+
+    ptr<BlockFinalizeDownloadAgent> getBlockFinalizeDownloadAgent() const;
+
     void postMessage(ptr<MessageEnvelope> m);
 
     ptr<PendingTransactionsAgent> getPendingTransactionsAgent() const;
@@ -44,6 +44,7 @@
 #include "pendingqueue/PendingTransactionsAgent.h"
 
 #include "blockfinalize/client/BlockFinalizeDownloader.h"
+#include "blockfinalize/client/BlockFinalizeDownloadAgent.h"
 #include "blockproposal/server/BlockProposalServerAgent.h"
 #include "catchup/client/CatchupClientAgent.h"
 #include "catchup/server/CatchupServerAgent.h"
@@ -63,6 +64,7 @@
 #include "protocols/ProtocolInstance.h"
 #include "protocols/blockconsensus/BlockConsensusAgent.h"
 #include "network/ClientSocket.h"
+#include "network/ClientSocketPool.h"
 #include "network/IO.h"
 #include "network/ZMQServerSocket.h"
 #include "SchainMessageThreadPool.h"
@@ -102,6 +104,15 @@ const ptr<IO> Schain::getIo() const {
     return io;
 }
 
+ptr<BlockFinalizeDownloadAgent> Schain::getBlockFinalizeDownloadAgent() const {
+    return blockFinalizeDownloadAgent;
+}
+
+ptr<ClientSocketPool> Schain::getClientSocketPool() const {
+    CHECK_STATE(clientSocketPool != nullptr);
+    return clientSocketPool;
+}
+
 
 ptr<PendingTransactionsAgent> Schain::getPendingTransactionsAgent() const {
     CHECK_STATE(pendingTransactionsAgent != nullptr)
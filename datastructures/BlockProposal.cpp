@@ -43,6 +43,7 @@
 #include "pendingqueue/PendingTransactionsAgent.h"
 #include "datastructures/BlockProposalFragment.h"
 #include "datastructures/BlockProposalFragmentList.h"
+#include "datastructures/ErasureCoder.h"
 #include "headers/BlockProposalRequestHeader.h"
 
 
@@ -340,6 +341,44 @@ ptr<BlockProposalFragment> BlockProposal::getFragment(uint64_t _totalFragments,
                                               sBlock->size(), getHash()->toHex());
 }
 
+ptr<BlockProposalFragment> BlockProposal::getErasureCodedFragment(uint64_t _totalFragments,
+                                                                 fragment_index _index) {
+
+    CHECK_ARGUMENT(_totalFragments > 0);
+    CHECK_ARGUMENT(_index > 0);
+    CHECK_ARGUMENT(_index <= _totalFragments);
+    LOCK(m)
+
+    auto sBlock = serialize();
+
+    auto dataFragments = ErasureCoder::getDataShardCount(_totalFragments);
+
+    if (erasureFragments == nullptr || erasureFragments->size() != _totalFragments) {
+
+        auto shards = ErasureCoder::encode(*sBlock, dataFragments, _totalFragments);
+
+        auto fragments = make_shared<vector<ptr<vector<uint8_t>>>>();
+        auto hashes = make_shared<vector<ptr<string>>>();
+
+        for (auto &&shard : *shards) {
+            auto fragmentData = make_shared<vector<uint8_t>>();
+            fragmentData->reserve(shard->size() + 2);
+            fragmentData->push_back('<');
+            fragmentData->insert(fragmentData->end(), shard->begin(), shard->end());
+            fragmentData->push_back('>');
+            hashes->push_back(BlockProposalFragment::hashPayload(*fragmentData));
+            fragments->push_back(fragmentData);
+        }
+
+        erasureFragments = fragments;
+        erasureFragmentHashes = hashes;
+    }
+
+    return make_shared<BlockProposalFragment>(getBlockID(), _totalFragments, _index,
+                                              erasureFragments->at((uint64_t) _index - 1), sBlock->size(),
+                                              getHash()->toHex(), dataFragments, erasureFragmentHashes);
+}
+
 ptr<TransactionList> BlockProposal::deserializeTransactions(ptr<BlockProposalHeader> _header,
                                                             ptr<string> _headerString,
                                                             ptr<vector<uint8_t> > _serializedBlock) {
@@ -48,6 +48,11 @@ class BlockProposal : public DataStructure {
 
     ptr< vector< uint8_t > > serializedProposal = nullptr;
 
+    // erasure coded fragments are computed once and served to every peer
+    ptr<vector<ptr<vector<uint8_t>>>> erasureFragments = nullptr;
+
+    ptr<vector<ptr<string>>> erasureFragmentHashes = nullptr;
+
 
 
 protected:
@@ -127,6 +132,8 @@ public:
 
     ptr<BlockProposalFragment> getFragment(uint64_t _totalFragments, fragment_index _index);
 
+    ptr<BlockProposalFragment> getErasureCodedFragment(uint64_t _totalFragments, fragment_index _index);
+
     u256 getStateRoot() const;
 
 };
@@ -23,6 +23,7 @@
 #include "SkaleCommon.h"
 #include "Log.h"
 #include "exceptions/ParsingException.h"
+#include "crypto/SHAHash.h"
 
 #include "BlockProposalFragment.h"
 
@@ -50,6 +51,47 @@ BlockProposalFragment::BlockProposalFragment(const block_id &blockId, const uint
     }
 }
 
+BlockProposalFragment::BlockProposalFragment(const block_id &blockId, const uint64_t totalFragments,
+                                             const fragment_index &fragmentIndex, const ptr<vector<uint8_t>> &data,
+                                             uint64_t _blockSize, ptr<string> _blockHash,
+                                             uint64_t _dataFragments, ptr<vector<ptr<string>>> _fragmentHashes) :
+        BlockProposalFragment(blockId, totalFragments, fragmentIndex, data, _blockSize, _blockHash) {
+
+    CHECK_ARGUMENT(_dataFragments > 0);
+    CHECK_ARGUMENT(_dataFragments <= totalFragments);
+    CHECK_ARGUMENT(_fragmentHashes != nullptr);
+    CHECK_ARGUMENT(fragmentIndex > 0);
+
+    if (_fragmentHashes->size() != totalFragments) {
+        BOOST_THROW_EXCEPTION(ParsingException("Fragment hash count does not match fragment count:" +
+                                               to_string(_fragmentHashes->size()), __CLASS_NAME__));
+    }
+
+    if (hashPayload(*data)->compare(*_fragmentHashes->at((uint64_t) fragmentIndex - 1)) != 0) {
+        BOOST_THROW_EXCEPTION(ParsingException("Fragment hash does not match", __CLASS_NAME__));
+    }
+
+    dataFragments = _dataFragments;
+    fragmentHashes = _fragmentHashes;
+}
+
+bool BlockProposalFragment::isErasureCoded() const {
+    return dataFragments > 0;
+}
+
+uint64_t BlockProposalFragment::getDataFragments() const {
+    return dataFragments;
+}
+
+ptr<vector<ptr<string>>> BlockProposalFragment::getFragmentHashes() const {
+    return fragmentHashes;
+}
+
+ptr<string> BlockProposalFragment::hashPayload(const vector<uint8_t> &_framedData) {
+    CHECK_ARGUMENT(_framedData.size() > 2);
+    return SHAHash::calculateHash((uint8_t *) _framedData.data() + 1, _framedData.size() - 2)->toHex();
+}
+
 uint64_t BlockProposalFragment::getBlockSize() const {
     return blockSize;
 }
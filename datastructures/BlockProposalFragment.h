@@ -36,12 +36,22 @@ class BlockProposalFragment {
 
     const ptr<vector<uint8_t>> data;
 
+    // zero for plain slices, otherwise any dataFragments of totalFragments rebuild the block
+    uint64_t dataFragments = 0;
+
+    // hex hashes of all erasure coded fragments, each fragment is checked against its entry
+    ptr<vector<ptr<string>>> fragmentHashes = nullptr;
+
 
 public:
 
     BlockProposalFragment(const block_id &blockId, const uint64_t totalFragments, const fragment_index &fragmentIndex,
                           const ptr<vector<uint8_t>> &data, uint64_t _blockSize, ptr<string> _blockHash);
 
+    BlockProposalFragment(const block_id &blockId, const uint64_t totalFragments, const fragment_index &fragmentIndex,
+                          const ptr<vector<uint8_t>> &data, uint64_t _blockSize, ptr<string> _blockHash,
+                          uint64_t _dataFragments, ptr<vector<ptr<string>>> _fragmentHashes);
+
     block_id getBlockId() const;
 
     uint64_t getTotalFragments() const;
@@ -54,6 +64,15 @@ public:
 
     ptr<string> getBlockHash() const;
 
+    bool isErasureCoded() const;
+
+    uint64_t getDataFragments() const;
+
+    ptr<vector<ptr<string>>> getFragmentHashes() const;
+
+    // hex hash of the fragment payload without the < > framing
+    static ptr<string> hashPayload(const vector<uint8_t> &_framedData);
+
 };
 
 
@@ -32,16 +32,20 @@
 #include "exceptions/SerializeException.h"
 
 #include "BlockProposalFragment.h"
+#include "ErasureCoder.h"
 
 
 #include "BlockProposalFragmentList.h"
 
 BlockProposalFragmentList::BlockProposalFragmentList(const block_id &_blockId,
-                                                       const uint64_t _totalFragments) :
+                                                       const uint64_t _totalFragments,
+                                                       const uint64_t _dataFragments) :
         blockID(_blockId),
         totalFragments(
-                _totalFragments) {
+                _totalFragments),
+        dataFragments(_dataFragments) {
     CHECK_ARGUMENT(totalFragments > 0);
+    CHECK_ARGUMENT(dataFragments <= totalFragments);
 
     for (uint64_t i = 1; i <= totalFragments; i++) {
         missingFragments.push_back(i);
@@ -79,6 +83,7 @@ bool BlockProposalFragmentList::addFragment(ptr<BlockProposalFragment> _fragment
     CHECK_ARGUMENT(_fragment->getIndex() > 0)
     CHECK_ARGUMENT(_fragment->getIndex() <= totalFragments);
     CHECK_ARGUMENT(_fragment->serialize() != nullptr)
+    CHECK_ARGUMENT(_fragment->getDataFragments() == dataFragments)
 
     LOCK(m)
 
@@ -90,11 +95,27 @@ bool BlockProposalFragmentList::addFragment(ptr<BlockProposalFragment> _fragment
         CHECK_ARGUMENT(blockSize == (int64_t ) _fragment->getBlockSize());
     }
 
+    if (dataFragments > 0) {
+        // the fragment already matched its own entry, the lists must agree across fragments
+        auto hashes = _fragment->getFragmentHashes();
+        if (fragmentHashes == nullptr) {
+            fragmentHashes = hashes;
+        } else {
+            for (uint64_t i = 0; i < totalFragments; i++) {
+                CHECK_ARGUMENT(fragmentHashes->at(i)->compare(*hashes->at(i)) == 0);
+            }
+        }
+    }
+
     checkSanity();
 
 
     nextIndex = 0;
 
+    if (isComplete()) {
+        return false;
+    }
+
     if (fragments.find(_fragment->getIndex()) != fragments.end()) {
         return false;
     }
@@ -136,6 +157,10 @@ bool BlockProposalFragmentList::isComplete() {
 
     checkSanity();
 
+    if (dataFragments > 0) {
+        return fragments.size() >= dataFragments;
+    }
+
     if (fragments.size() == totalFragments) {
         for (uint64_t i = 1; i <= totalFragments; i++) {
             CHECK_STATE(fragments.find(i) != fragments.end())
@@ -169,15 +194,27 @@ ptr<vector<uint8_t>> BlockProposalFragmentList::serialize() {
 
     try {
 
-        for (auto &&item : fragments) {
-            totalLen += item.second->size() - 2;
-        }
+        if (dataFragments > 0) {
+            map<uint64_t, ptr<vector<uint8_t>>> shards;
+
+            for (auto &&item : fragments) {
+                shards[(uint64_t) item.first - 1] = make_shared<vector<uint8_t>>(item.second->begin() + 1,
+                                                                                 item.second->end() - 1);
+            }
 
-        result->reserve(totalLen);
+            result = ErasureCoder::decode(shards, dataFragments, totalFragments, blockSize);
+            totalLen = result->size();
+        } else {
+            for (auto &&item : fragments) {
+                totalLen += item.second->size() - 2;
+            }
 
-        for (auto &&item : fragments) {
-            auto fragment = item.second;
-            result->insert(result->end(), fragment->begin() + 1, fragment->end() - 1);
+            result->reserve(totalLen);
+
+            for (auto &&item : fragments) {
+                auto fragment = item.second;
+                result->insert(result->end(), fragment->begin() + 1, fragment->end() - 1);
+            }
         }
 
     } catch (...) {
@@ -193,6 +230,10 @@ ptr<vector<uint8_t>> BlockProposalFragmentList::serialize() {
 }
 
 
+uint64_t BlockProposalFragmentList::getDataFragments() const {
+    return dataFragments;
+}
+
 boost::random::mt19937 BlockProposalFragmentList::gen;
 
 boost::random::uniform_int_distribution<> BlockProposalFragmentList::ubyte(0, 1024);
\ No newline at end of file
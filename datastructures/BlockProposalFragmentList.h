@@ -49,6 +49,11 @@ class BlockProposalFragmentList : public DataStructure {
 
     const uint64_t  totalFragments;
 
+    // zero for plain slices, otherwise the number of erasure coded fragments that rebuild the block
+    const uint64_t  dataFragments;
+
+    ptr<vector<ptr<string>>> fragmentHashes = nullptr;
+
     map<fragment_index, ptr<vector<uint8_t>>> fragments;
 
     list<uint64_t> missingFragments;
@@ -61,7 +66,8 @@ class BlockProposalFragmentList : public DataStructure {
     static boost::random::uniform_int_distribution<> ubyte;
 
 public:
-    BlockProposalFragmentList(const block_id &_blockId, const uint64_t _totalFragments);
+    BlockProposalFragmentList(const block_id &_blockId, const uint64_t _totalFragments,
+                              const uint64_t _dataFragments = 0);
 
     bool addFragment(ptr<BlockProposalFragment> _fragment, uint64_t& _nextIndexToRetrieve);
 
@@ -69,6 +75,8 @@ public:
 
     bool isComplete();
 
+    uint64_t getDataFragments() const;
+
     ptr<vector<uint8_t >> serialize();
 
 };
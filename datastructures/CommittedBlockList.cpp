@@ -41,34 +41,66 @@ CommittedBlockList::CommittedBlockList(ptr<vector<ptr<CommittedBlock> > > _block
 
 
 CommittedBlockList::CommittedBlockList(ptr<CryptoManager> _cryptoManager, ptr<vector<uint64_t> > _blockSizes, ptr<vector<uint8_t> > _serializedBlocks,
-                                       uint64_t _offset) {
+                                       uint64_t _offset, uint64_t _threadCount) {
     CHECK_ARGUMENT(_serializedBlocks->at(_offset) == '[');
     CHECK_ARGUMENT(_serializedBlocks->at(_serializedBlocks->size() - 1) == ']');
 
     try {
 
+        // block boundaries are known upfront, so blocks can be parsed and verified independently
+        vector<pair<size_t, size_t> > boundaries;
 
         size_t index = _offset + 1;
-        uint64_t counter = 0;
-
-        blocks = make_shared<vector<ptr<CommittedBlock> > >();
 
         for (auto &&size : *_blockSizes) {
             auto endIndex = index + size;
 
             ASSERT(endIndex <= _serializedBlocks->size());
 
-            auto blockData = make_shared<vector<uint8_t> >(_serializedBlocks->begin() + index,
-                                                           _serializedBlocks->begin() + endIndex);
-
-            CommittedBlock::serializedSanityCheck(blockData);
-            auto block = CommittedBlock::deserialize(blockData, _cryptoManager);
-
-            blocks->push_back(block);
+            boundaries.emplace_back(index, endIndex);
 
             index = endIndex;
+        }
 
-            counter++;
+        blocks = make_shared<vector<ptr<CommittedBlock> > >(boundaries.size());
+
+        auto deserializeRange = [&](size_t _begin, size_t _end) {
+            for (size_t i = _begin; i < _end; i++) {
+                auto blockData = make_shared<vector<uint8_t> >(_serializedBlocks->begin() + boundaries[i].first,
+                                                               _serializedBlocks->begin() + boundaries[i].second);
+
+                CommittedBlock::serializedSanityCheck(blockData);
+                blocks->at(i) = CommittedBlock::deserialize(blockData, _cryptoManager);
+            }
+        };
+
+        auto threadCount = min((uint64_t) boundaries.size(), _threadCount);
+
+        if (threadCount <= 1) {
+            deserializeRange(0, boundaries.size());
+        } else {
+            vector<thread> threads;
+            vector<exception_ptr> errors(threadCount);
+
+            for (uint64_t t = 0; t < threadCount; t++) {
+                threads.emplace_back([&, t]() {
+                    try {
+                        deserializeRange(t * boundaries.size() / threadCount,
+                                         (t + 1) * boundaries.size() / threadCount);
+                    } catch (...) {
+                        errors.at(t) = current_exception();
+                    }
+                });
+            }
+
+            for (auto &&t : threads) {
+                t.join();
+            }
+
+            for (auto &&error : errors) {
+                if (error)
+                    rethrow_exception(error);
+            }
         }
     } catch (exception &e) {
         Exception::logNested(e);
@@ -115,8 +147,9 @@ ptr<CommittedBlockList> CommittedBlockList::createRandomSample(
 
 ptr<CommittedBlockList>
 CommittedBlockList::deserialize(ptr<CryptoManager> _cryptoManager, ptr<vector<uint64_t> > _blockSizes, ptr<vector<uint8_t> > _serializedBlocks,
-                                uint64_t _offset) {
-    return ptr<CommittedBlockList>(new CommittedBlockList(_cryptoManager,_blockSizes, _serializedBlocks, _offset));
+                                uint64_t _offset, uint64_t _threadCount) {
+    return ptr<CommittedBlockList>(new CommittedBlockList(_cryptoManager,_blockSizes, _serializedBlocks, _offset,
+                                                          _threadCount));
 }
 
 ptr<vector<uint64_t> > CommittedBlockList::createSizes() {
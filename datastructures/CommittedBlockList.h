@@ -41,7 +41,7 @@ class CommittedBlockList : public DataStructure {
 
     CommittedBlockList(ptr<CryptoManager> _cryptoManager, ptr<vector<uint64_t> > _blockSizes,
                        ptr<vector<uint8_t> > _serializedBlocks,
-                       uint64_t offset = 0);
+                       uint64_t offset = 0, uint64_t _threadCount = 1);
 
 
 public:
@@ -54,10 +54,12 @@ public:
 
     ptr<vector<uint8_t> > serialize();
 
+    // with _threadCount > 1 blocks are parsed and verified in parallel, the list keeps block order
     static ptr<CommittedBlockList> deserialize(ptr<CryptoManager>
                                                _cryptoManager,
                                                ptr<vector<uint64_t> > _blockSizes,
-                                               ptr<vector<uint8_t> > _serializedBlocks, uint64_t _offset);
+                                               ptr<vector<uint8_t> > _serializedBlocks, uint64_t _offset,
+                                               uint64_t _threadCount = 1);
 
 
     static ptr<CommittedBlockList> createRandomSample(ptr<CryptoManager> _cryptoManager, uint64_t _size,
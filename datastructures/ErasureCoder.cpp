@@ -0,0 +1,238 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+    @file ErasureCoder.cpp
+    @author Stan Kladko
+    @date 2019
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/InvalidArgumentException.h"
+
+#include "ErasureCoder.h"
+
+namespace {
+
+struct GaloisTables {
+    uint8_t exp[512];
+    uint8_t log[256];
+
+    GaloisTables() {
+        uint32_t x = 1;
+        for (uint32_t i = 0; i < 255; i++) {
+            exp[i] = (uint8_t) x;
+            log[x] = (uint8_t) i;
+            x <<= 1;
+            if (x & 0x100)
+                x ^= 0x11d;
+        }
+        for (uint32_t i = 255; i < 512; i++) {
+            exp[i] = exp[i - 255];
+        }
+        log[0] = 0;
+    }
+};
+
+const GaloisTables &galois() {
+    static const GaloisTables tables;
+    return tables;
+}
+
+}
+
+uint8_t ErasureCoder::mul(uint8_t _a, uint8_t _b) {
+    if (_a == 0 || _b == 0)
+        return 0;
+    auto &t = galois();
+    return t.exp[t.log[_a] + t.log[_b]];
+}
+
+uint8_t ErasureCoder::inverse(uint8_t _a) {
+    CHECK_ARGUMENT(_a != 0);
+    auto &t = galois();
+    return t.exp[255 - t.log[_a]];
+}
+
+uint8_t ErasureCoder::cauchyCoefficient(uint64_t _parityRow, uint64_t _dataColumn, uint64_t _dataShards) {
+    // x = _dataShards + row and y = column never collide, so x ^ y is never zero
+    return inverse((uint8_t) ((_dataShards + _parityRow) ^ _dataColumn));
+}
+
+void ErasureCoder::mulAdd(uint8_t _coefficient, const vector<uint8_t> &_in, vector<uint8_t> &_out) {
+
+    if (_coefficient == 0)
+        return;
+
+    uint8_t row[256];
+    for (uint32_t i = 0; i < 256; i++) {
+        row[i] = mul(_coefficient, (uint8_t) i);
+    }
+
+    auto size = min(_in.size(), _out.size());
+
+    for (uint64_t i = 0; i < size; i++) {
+        _out[i] ^= row[_in[i]];
+    }
+}
+
+void ErasureCoder::invertMatrix(vector<vector<uint8_t>> &_matrix) {
+
+    auto n = _matrix.size();
+
+    vector<vector<uint8_t>> result(n, vector<uint8_t>(n, 0));
+
+    for (uint64_t i = 0; i < n; i++) {
+        result[i][i] = 1;
+    }
+
+    for (uint64_t column = 0; column < n; column++) {
+
+        auto pivot = column;
+
+        while (pivot < n && _matrix[pivot][column] == 0)
+            pivot++;
+
+        CHECK_STATE(pivot < n);
+
+        swap(_matrix[pivot], _matrix[column]);
+        swap(result[pivot], result[column]);
+
+        auto scale = inverse(_matrix[column][column]);
+
+        for (uint64_t j = 0; j < n; j++) {
+            _matrix[column][j] = mul(_matrix[column][j], scale);
+            result[column][j] = mul(result[column][j], scale);
+        }
+
+        for (uint64_t row = 0; row < n; row++) {
+            auto factor = _matrix[row][column];
+            if (row == column || factor == 0)
+                continue;
+            for (uint64_t j = 0; j < n; j++) {
+                _matrix[row][j] ^= mul(factor, _matrix[column][j]);
+                result[row][j] ^= mul(factor, result[column][j]);
+            }
+        }
+    }
+
+    _matrix = result;
+}
+
+ptr<vector<ptr<vector<uint8_t>>>> ErasureCoder::encode(const vector<uint8_t> &_data, uint64_t _dataShards,
+                                                       uint64_t _totalShards) {
+
+    CHECK_ARGUMENT(_dataShards > 0);
+    CHECK_ARGUMENT(_dataShards <= _totalShards);
+    CHECK_ARGUMENT(_totalShards <= 256);
+    CHECK_ARGUMENT(!_data.empty());
+
+    auto shardSize = (_data.size() + _dataShards - 1) / _dataShards;
+
+    auto shards = make_shared<vector<ptr<vector<uint8_t>>>>();
+    shards->reserve(_totalShards);
+
+    for (uint64_t i = 0; i < _dataShards; i++) {
+        auto shard = make_shared<vector<uint8_t>>(shardSize, 0);
+        auto begin = min(i * shardSize, (uint64_t) _data.size());
+        auto end = min(begin + shardSize, (uint64_t) _data.size());
+        copy(_data.begin() + begin, _data.begin() + end, shard->begin());
+        shards->push_back(shard);
+    }
+
+    for (uint64_t r = 0; r < _totalShards - _dataShards; r++) {
+        auto parity = make_shared<vector<uint8_t>>(shardSize, 0);
+        for (uint64_t c = 0; c < _dataShards; c++) {
+            mulAdd(cauchyCoefficient(r, c, _dataShards), *shards->at(c), *parity);
+        }
+        shards->push_back(parity);
+    }
+
+    return shards;
+}
+
+ptr<vector<uint8_t>> ErasureCoder::decode(const map<uint64_t, ptr<vector<uint8_t>>> &_shards, uint64_t _dataShards,
+                                          uint64_t _totalShards, uint64_t _dataSize) {
+
+    CHECK_ARGUMENT(_dataShards > 0);
+    CHECK_ARGUMENT(_dataShards <= _totalShards);
+    CHECK_ARGUMENT(_totalShards <= 256);
+    CHECK_ARGUMENT(_shards.size() >= _dataShards);
+
+    auto shardSize = _shards.begin()->second->size();
+
+    CHECK_ARGUMENT(shardSize * _dataShards >= _dataSize);
+
+    vector<uint64_t> indices;
+    vector<ptr<vector<uint8_t>>> received;
+
+    for (auto &&item : _shards) {
+        CHECK_ARGUMENT(item.first < _totalShards);
+        CHECK_ARGUMENT(item.second->size() == shardSize);
+        indices.push_back(item.first);
+        received.push_back(item.second);
+        if (indices.size() == _dataShards)
+            break;
+    }
+
+    vector<ptr<vector<uint8_t>>> dataShards;
+
+    if (indices.back() < _dataShards) {
+        // map is ordered, so these are exactly the data shards
+        dataShards = received;
+    } else {
+        vector<vector<uint8_t>> matrix(_dataShards, vector<uint8_t>(_dataShards, 0));
+
+        for (uint64_t i = 0; i < _dataShards; i++) {
+            if (indices[i] < _dataShards) {
+                matrix[i][indices[i]] = 1;
+            } else {
+                for (uint64_t c = 0; c < _dataShards; c++) {
+                    matrix[i][c] = cauchyCoefficient(indices[i] - _dataShards, c, _dataShards);
+                }
+            }
+        }
+
+        invertMatrix(matrix);
+
+        for (uint64_t c = 0; c < _dataShards; c++) {
+            auto shard = make_shared<vector<uint8_t>>(shardSize, 0);
+            for (uint64_t j = 0; j < _dataShards; j++) {
+                mulAdd(matrix[c][j], *received[j], *shard);
+            }
+            dataShards.push_back(shard);
+        }
+    }
+
+    auto result = make_shared<vector<uint8_t>>();
+    result->reserve(_dataSize);
+
+    for (auto &&shard : dataShards) {
+        auto count = min((uint64_t) shard->size(), _dataSize - result->size());
+        result->insert(result->end(), shard->begin(), shard->begin() + count);
+    }
+
+    CHECK_STATE(result->size() == _dataSize);
+
+    return result;
+}
+
+uint64_t ErasureCoder::getDataShardCount(uint64_t _totalShards) {
+    CHECK_ARGUMENT(_totalShards > 0);
+    // the shards come from the other N - 1 nodes, of which (N - 1) / 3 may be faulty
+    return max((uint64_t) 1, _totalShards - _totalShards / 3);
+}
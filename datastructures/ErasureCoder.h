@@ -0,0 +1,56 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+    @file ErasureCoder.h
+    @author Stan Kladko
+    @date 2019
+*/
+
+#ifndef SKALED_ERASURECODER_H
+#define SKALED_ERASURECODER_H
+
+
+// Systematic Reed-Solomon code over GF(2^8) with a Cauchy parity matrix.
+// The first _dataShards shards are plain slices of the input, the rest are parity,
+// and any _dataShards of the _totalShards shards rebuild the input.
+class ErasureCoder {
+
+    static uint8_t mul(uint8_t _a, uint8_t _b);
+
+    static uint8_t inverse(uint8_t _a);
+
+    static uint8_t cauchyCoefficient(uint64_t _parityRow, uint64_t _dataColumn, uint64_t _dataShards);
+
+    static void invertMatrix(vector<vector<uint8_t>> &_matrix);
+
+    static void mulAdd(uint8_t _coefficient, const vector<uint8_t> &_in, vector<uint8_t> &_out);
+
+public:
+
+    static ptr<vector<ptr<vector<uint8_t>>>> encode(const vector<uint8_t> &_data, uint64_t _dataShards,
+                                                    uint64_t _totalShards);
+
+    // _shards is indexed from 0, only the first _dataShards entries are used
+    static ptr<vector<uint8_t>> decode(const map<uint64_t, ptr<vector<uint8_t>>> &_shards, uint64_t _dataShards,
+                                       uint64_t _totalShards, uint64_t _dataSize);
+
+    // tolerates losing the fragments of a third of the peers
+    static uint64_t getDataShardCount(uint64_t _totalShards);
+};
+
+
+#endif //SKALED_ERASURECODER_H
@@ -34,6 +34,7 @@
 #include "SkaleCommon.h"
 #include "exceptions/ParsingException.h"
 #include "crypto/CryptoManager.h"
+#include "crypto/SHAHash.h"
 #include "chains/Schain.h"
 
 #include "CommittedBlock.h"
@@ -45,6 +46,10 @@
 
 #include "BlockProposalFragment.h"
 #include "BlockProposalFragmentList.h"
+#include "ErasureCoder.h"
+
+#include "messages/NetworkMessage.h"
+#include "messages/NetworkMessageFields.h"
 
 
 #define BOOST_PENDING_INTEGER_LOG2_HPP
@@ -131,6 +136,70 @@ void test_committed_block_fragment_defragment(bool _fail) {
 }
 
 
+void test_erasure_coded_fragment_defragment() {
+    boost::random::mt19937 gen;
+
+    boost::random::uniform_int_distribution<> ubyte(0, 255);
+
+    ConsensusEngine engine;
+
+    Schain chain;
+
+    auto cryptoManager = make_shared<CryptoManager>(chain);
+
+
+    for (int i = 1; i < 64; i++) {
+        auto t = CommittedBlock::createRandomSample(cryptoManager, i, gen, ubyte, i);
+
+        auto dataFragments = ErasureCoder::getDataShardCount(i);
+
+        auto list = make_shared<BlockProposalFragmentList>(i, i, dataFragments);
+
+        // any dataFragments of the fragments will do, take them in random order
+        vector<uint64_t> indices;
+        for (int j = 1; j <= i; j++) {
+            indices.push_back(j);
+        }
+        for (uint64_t j = indices.size() - 1; j > 0; j--) {
+            swap(indices.at(j), indices.at(ubyte(gen) % (j + 1)));
+        }
+
+        uint64_t next;
+
+        for (uint64_t j = 0; j < dataFragments; j++) {
+            next = 0;
+            REQUIRE(!list->isComplete());
+            REQUIRE(list->addFragment(t->getErasureCodedFragment(i, indices.at(j)), next));
+        }
+
+        REQUIRE(next == 0);
+        REQUIRE(list->isComplete());
+
+        if (dataFragments < (uint64_t) i) {
+            // a fragment that does not match its hash is rejected
+            auto good = t->getErasureCodedFragment(i, indices.back());
+            auto data = make_shared<vector<uint8_t>>(*good->serialize());
+            data->at(1 + ubyte(gen) % (data->size() - 2))++;
+            REQUIRE_THROWS(make_shared<BlockProposalFragment>(i, i, indices.back(), data, good->getBlockSize(),
+                                                              good->getBlockHash(), dataFragments,
+                                                              good->getFragmentHashes()));
+        }
+
+        ptr<BlockProposal> imp = nullptr;
+
+        try {
+            imp = CommittedBlock::defragment(list, cryptoManager);
+        } catch (Exception &e) {
+            Exception::logNested(e, err);
+            throw (e);
+        }
+        REQUIRE(imp != nullptr);
+
+        REQUIRE(*imp->serialize() == *t->serialize());
+    }
+}
+
+
 void test_tx_serialize_deserialize(bool _fail) {
     boost::random::mt19937 gen;
 
@@ -260,10 +329,47 @@ void test_committed_block_list_serialize_deserialize() {
                 throw (e);
             }
             REQUIRE(imp != nullptr);
+
+            auto parallel = CommittedBlockList::deserialize(cryptoManager, t->createSizes(), out, 0, 4);
+
+            REQUIRE(parallel->getBlocks()->size() == imp->getBlocks()->size());
+
+            for (size_t j = 0; j < imp->getBlocks()->size(); j++) {
+                REQUIRE(*parallel->getBlocks()->at(j)->getHash()->toHex() ==
+                        *imp->getBlocks()->at(j)->getHash()->toHex());
+            }
         }
     }
 }
 
+void benchmark_committed_block_list_deserialize() {
+    boost::random::mt19937 gen;
+
+    Schain chain;
+    auto cryptoManager = make_shared<CryptoManager>(chain);
+
+    boost::random::uniform_int_distribution<> ubyte(0, 255);
+
+    auto list = CommittedBlockList::createRandomSample(cryptoManager, 200, gen, ubyte);
+    auto sizes = list->createSizes();
+    auto out = list->serialize();
+
+    for (uint64_t threads : {(uint64_t) 1, (uint64_t) max(thread::hardware_concurrency(), 1u)}) {
+        auto begin = chrono::steady_clock::now();
+
+        for (int k = 0; k < 10; k++) {
+            auto imp = CommittedBlockList::deserialize(cryptoManager, sizes, out, 0, threads);
+            REQUIRE(imp->getBlocks()->size() == sizes->size());
+        }
+
+        auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - begin).count();
+
+        cerr << threads << " threads: " << 10 * sizes->size() * 1000 / max((int64_t) ms, (int64_t) 1)
+             << " blocks/s, " << out->size() * 10 * 1000 / max((int64_t) ms, (int64_t) 1) / 1000000 << " MB/s"
+             << endl;
+    }
+}
+
 
 TEST_CASE("Serialize/deserialize transaction", "[tx-serialize]") {
     SECTION("Test successful serialize/deserialize")
@@ -316,6 +422,10 @@ TEST_CASE("Serialize/deserialize committed block list", "[committed-block-list-s
     // Test successful serialize/deserialize failure
 }
 
+TEST_CASE("Benchmark committed block list deserialize", "[committed-block-list-benchmark][.]") {
+    benchmark_committed_block_list_deserialize();
+}
+
 TEST_CASE("Test committed block fragment/defragment", "[committed-block-defragment]") {
     SECTION("Test successful serialize/deserialize")
 
@@ -328,6 +438,186 @@ TEST_CASE("Test committed block fragment/defragment", "[committed-block-defragme
     // Test successful serialize/deserialize failure
 }
 
+ptr<NetworkMessageFields> create_random_message_fields(boost::random::mt19937 &_gen,
+                                                       boost::random::uniform_int_distribution<> &_ubyte,
+                                                       MsgType _type) {
+    auto fields = make_shared<NetworkMessageFields>();
+    fields->schainID = _ubyte(_gen);
+    fields->blockID = ((uint64_t) _ubyte(_gen) << 24) + _ubyte(_gen);
+    fields->blockProposerIndex = _ubyte(_gen) % 16 + 1;
+    fields->msgType = _type;
+    fields->msgID = ((uint64_t) _ubyte(_gen) << 40) + _ubyte(_gen);
+    fields->srcNodeID = _ubyte(_gen);
+    fields->srcSchainIndex = _ubyte(_gen) % 16 + 1;
+    fields->round = _ubyte(_gen) % 4;
+    fields->value = _ubyte(_gen) % 2;
+
+    if (_type != MSG_BVB_BROADCAST) {
+        fields->sigShare = make_shared<string>();
+        for (int i = 0; i < 160; i++) {
+            fields->sigShare->push_back('0' + _ubyte(_gen) % 10);
+        }
+    }
+
+    return fields;
+}
+
+// a network message built straight from wire fields, so that the tests exercise the
+// production JSON encoder without a running schain to create sig shares
+class SampleNetworkMessage : public NetworkMessage {
+public:
+    explicit SampleNetworkMessage(const ptr<NetworkMessageFields> &_fields)
+            : NetworkMessage(_fields->msgType, node_id(_fields->srcNodeID), block_id(_fields->blockID),
+                             schain_index(_fields->blockProposerIndex), bin_consensus_round(_fields->round),
+                             bin_consensus_value(_fields->value), schain_id(_fields->schainID),
+                             msg_id(_fields->msgID), nullptr, schain_index(_fields->srcSchainIndex), nullptr) {
+        sigShareString = _fields->sigShare;
+    }
+};
+
+void require_same_fields(const ptr<NetworkMessageFields> &_a, const ptr<NetworkMessageFields> &_b) {
+    REQUIRE(_a->schainID == _b->schainID);
+    REQUIRE(_a->blockID == _b->blockID);
+    REQUIRE(_a->blockProposerIndex == _b->blockProposerIndex);
+    REQUIRE(_a->msgType == _b->msgType);
+    REQUIRE(_a->msgID == _b->msgID);
+    REQUIRE(_a->srcNodeID == _b->srcNodeID);
+    REQUIRE(_a->srcSchainIndex == _b->srcSchainIndex);
+    REQUIRE(_a->round == _b->round);
+    REQUIRE(_a->value == _b->value);
+    REQUIRE((_a->sigShare == nullptr) == (_b->sigShare == nullptr));
+    if (_a->sigShare)
+        REQUIRE(*_a->sigShare == *_b->sigShare);
+}
+
+void test_network_message_serialize_deserialize(bool _fail) {
+    boost::random::mt19937 gen;
+
+    boost::random::uniform_int_distribution<> ubyte(0, 255);
+
+    for (auto type : {MSG_BVB_BROADCAST, MSG_AUX_BROADCAST, MSG_BLOCK_SIGN_BROADCAST}) {
+        for (int i = 0; i < 1000; i++) {
+            auto t = create_random_message_fields(gen, ubyte, type);
+
+            auto message = make_shared<SampleNetworkMessage>(t);
+
+            require_same_fields(t, message->getFields());
+
+            auto binary = message->serializeToBinary();
+            auto json = message->serializeToString();
+
+            REQUIRE(NetworkMessageFields::isBinary(*binary));
+            REQUIRE(!NetworkMessageFields::isBinary(*json));
+            REQUIRE(binary->size() < json->size());
+
+            if (_fail) {
+                binary->pop_back();
+                REQUIRE_THROWS(NetworkMessageFields::parse(*binary));
+                binary->append("xx");
+                REQUIRE_THROWS(NetworkMessageFields::parse(*binary));
+            } else {
+                require_same_fields(t, NetworkMessageFields::parse(*binary));
+                require_same_fields(t, NetworkMessageFields::parse(*json));
+            }
+        }
+    }
+}
+
+void test_network_message_batch(bool _fail) {
+    boost::random::mt19937 gen;
+
+    boost::random::uniform_int_distribution<> ubyte(0, 255);
+
+    for (int i = 1; i < 50; i++) {
+        vector<ptr<NetworkMessageFields>> fields;
+        vector<ptr<string>> messages;
+
+        for (int j = 0; j < i; j++) {
+            fields.push_back(create_random_message_fields(gen, ubyte, j % 2 ? MSG_AUX_BROADCAST : MSG_BVB_BROADCAST));
+            messages.push_back(fields.back()->serializeToBinary());
+        }
+
+        auto batch = NetworkMessageFields::packBatch(messages);
+
+        REQUIRE(NetworkMessageFields::isBatch(batch->data(), batch->size()));
+
+        if (_fail) {
+            batch->pop_back();
+            REQUIRE_THROWS(NetworkMessageFields::unpackBatch(batch->data(), batch->size()));
+        } else {
+            auto unpacked = NetworkMessageFields::unpackBatch(batch->data(), batch->size());
+            REQUIRE(unpacked->size() == fields.size());
+            for (int j = 0; j < i; j++) {
+                require_same_fields(fields.at(j),
+                                    NetworkMessageFields::parse(unpacked->at(j).first, unpacked->at(j).second));
+            }
+        }
+    }
+}
+
+void benchmark_network_message_encoding() {
+    boost::random::mt19937 gen;
+
+    boost::random::uniform_int_distribution<> ubyte(0, 255);
+
+    vector<ptr<SampleNetworkMessage>> samples;
+
+    for (int i = 0; i < 1000; i++) {
+        samples.push_back(make_shared<SampleNetworkMessage>(
+                create_random_message_fields(gen, ubyte, i % 2 ? MSG_AUX_BROADCAST : MSG_BVB_BROADCAST)));
+    }
+
+    for (bool binary : {false, true}) {
+        uint64_t bytes = 0;
+
+        auto begin = chrono::steady_clock::now();
+
+        for (int k = 0; k < 100; k++) {
+            for (auto &&sample : samples) {
+                auto s = binary ? sample->serializeToBinary() : sample->serializeToString();
+                bytes += s->size();
+                REQUIRE(NetworkMessageFields::parse(*s)->blockID == (uint64_t) sample->getBlockId());
+            }
+        }
+
+        auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+
+        cerr << (binary ? "binary" : "json") << ": " << ns / (100 * samples.size()) << " ns/msg, "
+             << bytes / (100 * samples.size()) << " bytes/msg" << endl;
+    }
+}
+
+TEST_CASE("Test erasure coded fragment/defragment", "[erasure-coded-defragment]") {
+    SECTION("Test successful k-of-n defragment")
+
+        test_erasure_coded_fragment_defragment();
+}
+
+
+TEST_CASE("Serialize/deserialize network message", "[network-message-serialize]") {
+    SECTION("Test successful serialize/deserialize")
+
+        test_network_message_serialize_deserialize(false);
+
+    SECTION("Test corrupt serialize/deserialize")
+
+        test_network_message_serialize_deserialize(true);
+}
+
+TEST_CASE("Pack/unpack network message batch", "[network-message-batch]") {
+    SECTION("Test successful pack/unpack")
+
+        test_network_message_batch(false);
+
+    SECTION("Test corrupt pack/unpack")
+
+        test_network_message_batch(true);
+}
+
+TEST_CASE("Benchmark network message encodings", "[network-message-benchmark][.]") {
+    benchmark_network_message_encoding();
+}
+
 
 class CryptoFixture {
 public:
@@ -35,26 +35,36 @@ ptr<vector<uint8_t> > BlockDB::getSerializedBlockFromLevelDB(block_id _blockID)
 
     try {
 
-        auto key = createKey(_blockID);
+        auto serializedBlock = make_shared<vector<uint8_t>>();
 
-        auto value = readString(*key);
-
-        if (value) {
-            auto serializedBlock = make_shared<vector<uint8_t>>();
-            serializedBlock->insert(serializedBlock->begin(), value->data(), value->data() + value->size());
-            CommittedBlock::serializedSanityCheck(serializedBlock);
-            return serializedBlock;
-        } else {
+        if (!appendSerializedBlock(_blockID, *serializedBlock))
             return nullptr;
-        }
+
+        return serializedBlock;
+
     } catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
     }
 }
 
-BlockDB::BlockDB(Schain *_sChain, string &_dirname, string &_prefix, node_id _nodeId, uint64_t _maxDBSize)
+bool BlockDB::appendSerializedBlock(block_id _blockID, vector<uint8_t> &_buffer) {
+
+    auto start = _buffer.size();
+
+    if (!appendValue(createKey(_blockID), _buffer))
+        return false;
+
+    CHECK_STATE(_buffer.size() > start + sizeof(uint64_t));
+    CHECK_STATE(_buffer.at(start + sizeof(uint64_t)) == '{');
+    CHECK_STATE(_buffer.back() == '>');
+
+    return true;
+}
+
+BlockDB::BlockDB(Schain *_sChain, string &_dirname, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                 const LevelDBProfile &_profile)
         : CacheLevelDB(_sChain, _dirname, _prefix,
-                       _nodeId, _maxDBSize, false) {
+                       _nodeId, _maxDBSize, _profile, false) {
 
 
 }
@@ -72,7 +82,7 @@ void BlockDB::saveBlock2LevelDB(ptr<CommittedBlock> &_block) {
 
         auto key = createKey(_block->getBlockID());
         
-        writeByteArray(*key, serializedBlock);
+        writeByteArray(key, serializedBlock);
         writeString(createLastCommittedKey(), to_string(_block->getBlockID()), true);
     } catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
@@ -83,15 +93,13 @@ void BlockDB::saveBlock2LevelDB(ptr<CommittedBlock> &_block) {
 
 
 
-string BlockDB::createLastCommittedKey() {
-    return getFormatVersion() + ":last";
+DBKey BlockDB::createLastCommittedKey() {
+    DBKey key;
+    key.addTag(DBKey::LAST);
+    return key;
 }
 
 
-const string BlockDB::getFormatVersion() {
-    return "1.0";
-}
-
 
 void BlockDB::saveBlock(ptr<CommittedBlock> &_block) {
 
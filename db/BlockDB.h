@@ -38,16 +38,18 @@ class BlockDB : public CacheLevelDB {
 
 public:
 
-    BlockDB(Schain *_sChain, string &_dirname, string &_prefix, node_id _nodeId, uint64_t _maxDBSize);
+    BlockDB(Schain *_sChain, string &_dirname, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+            const LevelDBProfile &_profile);
     ptr<vector<uint8_t >> getSerializedBlockFromLevelDB(block_id _blockID);
+
+    // appends the serialized block to _buffer without intermediate copies, returns false if it is missing
+    bool appendSerializedBlock(block_id _blockID, vector<uint8_t> &_buffer);
     void saveBlock(ptr<CommittedBlock> &_block);
     ptr<CommittedBlock> getBlock(block_id _blockID, ptr<CryptoManager> _cryptoManager);
 
     block_id readLastCommittedBlockID();
 
-    const string getFormatVersion();
-
-    string createLastCommittedKey();
+    DBKey createLastCommittedKey();
 };
 
 
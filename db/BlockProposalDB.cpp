@@ -46,12 +46,15 @@
 
 using namespace std;
 
-#define PROPOSAL_CACHE_SIZE 3
-
 BlockProposalDB::BlockProposalDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId,
-                                 uint64_t _maxDBSize) :
-        CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, true) {
-    proposalCache = make_shared<cache::lru_cache<string, ptr<BlockProposal>>>(PROPOSAL_CACHE_SIZE);
+                                 uint64_t _maxDBSize, const LevelDBProfile &_profile, uint64_t _cacheBlocks) :
+        CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, _profile, true) {
+
+    CHECK_ARGUMENT(_cacheBlocks > 0);
+
+    for (uint64_t i = 0; i < totalSigners; i++) {
+        proposalCaches.push_back(make_shared<cache::lru_cache<uint64_t, ptr<BlockProposal>>>(_cacheBlocks));
+    }
 };
 
 void BlockProposalDB::addBlockProposal(ptr<BlockProposal> _proposal) {
@@ -67,6 +70,15 @@ void BlockProposalDB::addBlockProposal(ptr<BlockProposal> _proposal) {
 
     try {
 
+        LOCK(proposalMutex);
+
+        // the first proposal stored for a slot wins, a later one must not replace it in the cache
+        if (proposalExists(_proposal->getBlockID(), _proposal->getProposerIndex())) {
+            LOG(trace, "Duplicate block proposal " + to_string(_proposal->getBlockID()) + ":" +
+                       to_string(_proposal->getProposerIndex()));
+            return;
+        }
+
         ptr<vector<uint8_t> > serialized;
 
 
@@ -75,6 +87,10 @@ void BlockProposalDB::addBlockProposal(ptr<BlockProposal> _proposal) {
         this->writeByteArrayToSet((const char *) serialized->data(), serialized->size(), _proposal->getBlockID(),
                                   _proposal->getProposerIndex());
 
+        // the proposal is read back on decide and commit, keep it so that it is not deserialized again
+        proposalCaches.at((uint64_t) _proposal->getProposerIndex() - 1)->put((uint64_t) _proposal->getBlockID(),
+                                                                            _proposal);
+
     } catch (ExitRequestedException &e) { throw; }
     catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
@@ -88,16 +104,13 @@ BlockProposalDB::getSerializedProposalFromLevelDB(block_id _blockID, schain_inde
 
     try {
 
-        auto value = readStringFromBlockSet(_blockID, _proposerIndex);
+        auto serializedBlock = make_shared<vector<uint8_t>>();
 
-        if (value) {
-            auto serializedBlock = make_shared<vector<uint8_t>>();
-            serializedBlock->insert(serializedBlock->begin(), value->data(), value->data() + value->size());
-            CommittedBlock::serializedSanityCheck(serializedBlock);
-            return serializedBlock;
-        } else {
+        if (!appendValue(createSetKey(_blockID, _proposerIndex), *serializedBlock))
             return nullptr;
-        }
+
+        CommittedBlock::serializedSanityCheck(serializedBlock);
+        return serializedBlock;
     } catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
     }
@@ -107,14 +120,19 @@ BlockProposalDB::getSerializedProposalFromLevelDB(block_id _blockID, schain_inde
 ptr<BlockProposal> BlockProposalDB::getBlockProposal(block_id _blockID, schain_index _proposerIndex) {
 
 
+    CHECK_ARGUMENT(_proposerIndex > 0 && _proposerIndex <= totalSigners);
+
     LOCK(proposalMutex);
 
-    auto key = createSetKey(_blockID, _proposerIndex);
+    auto proposalCache = proposalCaches.at((uint64_t) _proposerIndex - 1);
 
-    if (proposalCache->exists(key)) {
-        return proposalCache->get(key);
+    if (proposalCache->exists((uint64_t) _blockID)) {
+        cacheHits++;
+        return proposalCache->get((uint64_t) _blockID);
     }
 
+    cacheMisses++;
+
     auto serializedProposal = getSerializedProposalFromLevelDB(_blockID, _proposerIndex);
 
     if (serializedProposal == nullptr)
@@ -125,7 +143,7 @@ ptr<BlockProposal> BlockProposalDB::getBlockProposal(block_id _blockID, schain_i
     if (proposal == nullptr)
         return nullptr;
 
-    proposalCache->put(key, proposal);
+    proposalCache->put((uint64_t) _blockID, proposal);
 
     CHECK_STATE(proposal->getSignature() != nullptr);
 
@@ -133,8 +151,12 @@ ptr<BlockProposal> BlockProposalDB::getBlockProposal(block_id _blockID, schain_i
 }
 
 
-const string BlockProposalDB::getFormatVersion() {
-    return "1.0";
+uint64_t BlockProposalDB::getCacheHits() const {
+    return cacheHits;
+}
+
+uint64_t BlockProposalDB::getCacheMisses() const {
+    return cacheMisses;
 }
 
 bool BlockProposalDB::proposalExists(block_id _blockId, schain_index _index) {
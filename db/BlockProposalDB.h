@@ -39,7 +39,11 @@ class BlockProposalDB : public CacheLevelDB {
 
     recursive_mutex proposalMutex;
 
-    ptr<cache::lru_cache<string, ptr<BlockProposal>>> proposalCache;
+    // one cache per proposer, keyed by block id
+    vector<ptr<cache::lru_cache<uint64_t, ptr<BlockProposal>>>> proposalCaches;
+
+    atomic<uint64_t> cacheHits = 0;
+    atomic<uint64_t> cacheMisses = 0;
 
 public:
 
@@ -50,13 +54,16 @@ public:
 
     ptr<BlockProposal> getBlockProposal(block_id _blockID, schain_index _proposerIndex);
 
-    BlockProposalDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize);
+    BlockProposalDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                    const LevelDBProfile &_profile, uint64_t _cacheBlocks);
 
     void addBlockProposal(ptr<BlockProposal> _proposal);
 
-    const string getFormatVersion();
-
     ptr<vector<uint8_t> > getSerializedProposalFromLevelDB(block_id _blockID, schain_index _proposerIndex);
+
+    uint64_t getCacheHits() const;
+
+    uint64_t getCacheMisses() const;
 };
 
 
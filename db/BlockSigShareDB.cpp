@@ -41,8 +41,8 @@
 
 
 BlockSigShareDB::BlockSigShareDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId,
-                                 uint64_t _maxDBSize)
-        : CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, false) {
+                                 uint64_t _maxDBSize, const LevelDBProfile &_profile)
+        : CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, _profile, false) {
     CHECK_ARGUMENT(sChain != nullptr);
 }
 
@@ -82,10 +82,6 @@ BlockSigShareDB::checkAndSaveShare(ptr<ThresholdSigShare> _sigShare, ptr<CryptoM
 }
 
 
-const string BlockSigShareDB::getFormatVersion() {
-    return "1.0";
-}
-
 
 
 
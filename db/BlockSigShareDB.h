@@ -37,11 +37,10 @@ class BlockSigShareDB : public CacheLevelDB {
 
     recursive_mutex sigShareMutex;
 
-    const string getFormatVersion();
-
 public:
 
-    BlockSigShareDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize);
+    BlockSigShareDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                    const LevelDBProfile &_profile);
 
     ptr<ThresholdSignature> checkAndSaveShare(ptr<ThresholdSigShare> _sigShare, ptr<CryptoManager> _cryptoManager);
 
@@ -36,6 +36,10 @@
 #include "thirdparty/json.hpp"
 #include "leveldb/db.h"
 #include "leveldb/write_batch.h"
+#include "leveldb/filter_policy.h"
+#include "leveldb/cache.h"
+
+#include <sys/resource.h>
 
 #include "chains/Schain.h"
 #include "datastructures/TransactionList.h"
@@ -59,91 +63,275 @@ using namespace leveldb;
 static WriteOptions writeOptions;
 static ReadOptions readOptions;
 
+thread_local CacheLevelDB::PendingBatch CacheLevelDB::pendingBatch;
+
+// marks a db directory that has been opened ahead of rotation and does not hold data yet
+static const string PREOPENED_DB_MARKER = "PREOPENED";
+
 std::string CacheLevelDB::path_to_index(uint64_t index){
     return dirname + "/db." + to_string(index);
 }
 
-ptr<string> CacheLevelDB::createKey(const block_id _blockId, uint64_t _counter) {
-    return make_shared<string>(
-            getFormatVersion() + ":" + to_string(_blockId) + ":" + to_string(_counter));
+DBKey CacheLevelDB::createKey(const block_id _blockId, uint64_t _counter) {
+    DBKey key(_blockId);
+    key.add(_counter);
+    return key;
 }
 
-ptr<string> CacheLevelDB::createKey(const block_id _blockId) {
-    return make_shared<string>(getFormatVersion() + ":" + to_string(_blockId));
+DBKey CacheLevelDB::createKey(const block_id _blockId) {
+    return DBKey(_blockId);
 }
 
 
-ptr<string> CacheLevelDB::createKey(block_id _blockId, schain_index _proposerIndex) {
-    return make_shared<string>(
-            getFormatVersion() + ":" + to_string(_blockId) + ":" + to_string(_proposerIndex));
+DBKey CacheLevelDB::createKey(block_id _blockId, schain_index _proposerIndex) {
+    DBKey key(_blockId);
+    key.add((uint64_t) _proposerIndex);
+    return key;
 }
 
-ptr<string>
+DBKey
 CacheLevelDB::createKey(const block_id &_blockId, const schain_index &_proposerIndex,
                         const bin_consensus_round &_round) {
-    return make_shared<string>(getFormatVersion() + ":" + to_string(_blockId) + ":" + to_string(_proposerIndex) + ":" +
-                               to_string(_round));
+    DBKey key(_blockId);
+    key.add((uint64_t) _proposerIndex).add((uint64_t) _round);
+    return key;
 }
 
 
-string CacheLevelDB::createSetKey(block_id _blockId, schain_index _index) {
-    return getFormatVersion() + ":" + to_string(_blockId) + ":" + to_string(_index);
-}
-
-string CacheLevelDB::createCounterKey(block_id _blockId) {
-    return getFormatVersion() + ":COUNTER:" + to_string(_blockId);
+DBKey CacheLevelDB::createSetKey(block_id _blockId, schain_index _index) {
+    return createKey(_blockId, _index);
 }
 
-
 ptr<string> CacheLevelDB::readStringFromBlockSet(block_id _blockId, schain_index _index) {
-    auto key = createSetKey(_blockId, _index);
-    return readString(key);
+    return readString(createSetKey(_blockId, _index));
 }
 
 
 bool CacheLevelDB::keyExistsInSet(block_id _blockId, schain_index _index) {
-    return keyExists(createSetKey(_blockId, _index));
+
+    CHECK_ARGUMENT(_index > 0 && _index <= totalSigners);
+
+    LOCK(setLocks.at((uint64_t) _blockId % SET_LOCK_STRIPES));
+
+    return getBlockSetUnsafe(_blockId)->added.at((uint64_t) _index);
 }
 
 Schain *CacheLevelDB::getSchain() const {
     return sChain;
 }
 
-ptr<string> CacheLevelDB::readString(string &_key) {
+bool CacheLevelDB::mayContainBlock(uint64_t _dbIndex, block_id _blockId) {
+    // block id 0 means the key is not tied to a block, so every db has to be probed
+    if (_blockId == 0)
+        return true;
+    return minBlockIDs.at(_dbIndex) <= (uint64_t) _blockId && (uint64_t) _blockId <= maxBlockIDs.at(_dbIndex);
+}
+
+void CacheLevelDB::addBlockToRange(uint64_t _dbIndex, block_id _blockId) {
+
+    if (_blockId == 0)
+        return;
+
+    auto &minID = minBlockIDs.at(_dbIndex);
+    auto &maxID = maxBlockIDs.at(_dbIndex);
+
+    uint64_t current = minID;
+    while ((uint64_t) _blockId < current && !minID.compare_exchange_weak(current, (uint64_t) _blockId));
+
+    current = maxID;
+    while ((uint64_t) _blockId > current && !maxID.compare_exchange_weak(current, (uint64_t) _blockId));
+}
+
+void CacheLevelDB::extendBlockRangeFromDB(uint64_t _dbIndex, const DBKey &_prefix, const DBKey &_limit) {
+
+    // keys are sorted numerically, so the first and the last key under the prefix
+    // hold the smallest and the largest block ids
+
+    auto blockIdField = _prefix.getFieldCount();
+
+    auto it = ptr<Iterator>(db.at(_dbIndex)->NewIterator(readOptions));
+
+    it->Seek(Slice(_prefix.getData(), _prefix.getSize()));
+
+    // raw keys written through writeByteArray() can share the prefix, they are skipped
+    while (it->Valid() && _prefix.isPrefixOf(it->key().data(), it->key().size()) &&
+           !DBKey::isValid(it->key().ToString())) {
+        it->Next();
+    }
+
+    if (!it->Valid() || !_prefix.isPrefixOf(it->key().data(), it->key().size()))
+        return;
+
+    auto firstKey = it->key().ToString();
+
+    // after skipping raw keys the iterator may have passed the limit
+    if (firstKey >= string(_limit.getData(), _limit.getSize()))
+        return;
+
+    if (DBKey::getFieldCount(firstKey) <= blockIdField)
+        return;
+
+    addBlockToRange(_dbIndex, DBKey::getField(firstKey, blockIdField));
+
+    it->Seek(Slice(_limit.getData(), _limit.getSize()));
+
+    if (it->Valid()) {
+        it->Prev();
+    } else {
+        it->SeekToLast();
+    }
+
+    while (it->Valid() && _prefix.isPrefixOf(it->key().data(), it->key().size()) &&
+           !DBKey::isValid(it->key().ToString())) {
+        it->Prev();
+    }
+
+    if (!it->Valid() || !_prefix.isPrefixOf(it->key().data(), it->key().size()))
+        return;
+
+    auto lastKey = it->key().ToString();
+
+    if (DBKey::getFieldCount(lastKey) > blockIdField && DBKey::getField(lastKey, blockIdField) < DBKey::TAG_BASE)
+        addBlockToRange(_dbIndex, DBKey::getField(lastKey, blockIdField));
+}
+
+void CacheLevelDB::initBlockRange(uint64_t _dbIndex) {
+
+    CHECK_STATE(db.at(_dbIndex));
+
+    if (hasLegacyKeys.at(_dbIndex)) {
+        // block ids of legacy entries are unknown, so the db can not be skipped
+        minBlockIDs.at(_dbIndex) = 0;
+        maxBlockIDs.at(_dbIndex) = UINT64_MAX;
+        return;
+    }
+
+    minBlockIDs.at(_dbIndex) = UINT64_MAX;
+    maxBlockIDs.at(_dbIndex) = 0;
+
+    // keys that start with a block id. Set counters are kept in memory, so no tagged key holds a block id
+
+    DBKey tagged;
+    tagged.add(DBKey::TAG_BASE);
+    extendBlockRangeFromDB(_dbIndex, DBKey(), tagged);
+}
+
+void CacheLevelDB::initLegacyKeys(uint64_t _dbIndex) {
+
+    CHECK_STATE(db.at(_dbIndex));
+
+    string legacyPrefix = string(DBKey::LEGACY_FORMAT_VERSION) + ":";
+
+    auto it = ptr<Iterator>(db.at(_dbIndex)->NewIterator(readOptions));
+    it->Seek(legacyPrefix);
+
+    hasLegacyKeys.at(_dbIndex) = it->Valid() && it->key().starts_with(legacyPrefix);
+
+    if (hasLegacyKeys.at(_dbIndex)) {
+        LOG(info, "Found legacy format keys in " + path_to_index(highestDBIndex - LEVELDB_PIECES + 1 + _dbIndex));
+    }
+}
+
+bool CacheLevelDB::readFromDBUnsafe(uint64_t _dbIndex, const DBKey &_key, string &_value) {
+
+    if (!mayContainBlock(_dbIndex, _key.getBlockId()))
+        return false;
+
+    ASSERT(db[_dbIndex] != nullptr);
+
+    auto status = db[_dbIndex]->Get(readOptions, Slice(_key.getData(), _key.getSize()), &_value);
+    throwExceptionOnError(status);
+
+    if (!status.IsNotFound())
+        return true;
+
+    if (!hasLegacyKeys[_dbIndex])
+        return false;
+
+    status = db[_dbIndex]->Get(readOptions, _key.toLegacyString(), &_value);
+    throwExceptionOnError(status);
+
+    return !status.IsNotFound();
+}
+
+bool CacheLevelDB::appendValueFromDBUnsafe(uint64_t _dbIndex, const Slice &_key, vector<uint8_t> &_buffer) {
+
+    auto it = ptr<Iterator>(db.at(_dbIndex)->NewIterator(readOptions));
+
+    it->Seek(_key);
+
+    if (!it->Valid() || it->key() != _key)
+        return false;
+
+    // the value slice stays valid until the iterator moves
+    auto value = it->value();
+    _buffer.insert(_buffer.end(), (const uint8_t *) value.data(), (const uint8_t *) value.data() + value.size());
+
+    return true;
+}
+
+bool CacheLevelDB::appendValue(const DBKey &_key, vector<uint8_t> &_buffer) {
+
+    shared_lock<shared_mutex> lock(m);
+
+    Slice key(_key.getData(), _key.getSize());
+
+    for (int i = LEVELDB_PIECES - 1; i >= 0; i--) {
+
+        if (!mayContainBlock(i, _key.getBlockId()))
+            continue;
+
+        if (appendValueFromDBUnsafe(i, key, _buffer))
+            return true;
+
+        if (hasLegacyKeys[i] && appendValueFromDBUnsafe(i, _key.toLegacyString(), _buffer))
+            return true;
+    }
+
+    return false;
+}
+
+ptr<string> CacheLevelDB::readString(const DBKey &_key) {
     shared_lock<shared_mutex> lock(m);
     return readStringUnsafe(_key);
 }
 
 
-ptr<string> CacheLevelDB::readStringUnsafe(string &_key) {
+ptr<string> CacheLevelDB::readStringUnsafe(const DBKey &_key) {
+
+    if (isBatching()) {
+        auto entry = pendingBatch.entries.find(string(_key.getData(), _key.getSize()));
+        if (entry != pendingBatch.entries.end())
+            return make_shared<string>(entry->second.first);
+    }
+
+    string value;
 
     for (int i = LEVELDB_PIECES - 1; i >= 0; i--) {
-        auto result = make_shared<string>();
-        ASSERT(db[i] != nullptr);
-        auto status = db[i]->Get(readOptions, _key, &*result);
-        throwExceptionOnError(status);
-        if (!status.IsNotFound())
-            return result;
+        if (readFromDBUnsafe(i, _key, value))
+            return make_shared<string>(move(value));
     }
 
     return nullptr;
 }
 
-bool CacheLevelDB::keyExistsUnsafe(const string &_key) {
+bool CacheLevelDB::keyExistsUnsafe(const DBKey &_key) {
+
+    if (isBatching() && pendingBatch.entries.count(string(_key.getData(), _key.getSize())) > 0)
+        return true;
+
+    // reuse the buffer so that repeated lookups do not allocate
+    static thread_local string value;
 
     for (int i = LEVELDB_PIECES - 1; i >= 0; i--) {
-        auto result = make_shared<string>();
-        ASSERT(db[i] != nullptr);
-        auto status = db[i]->Get(readOptions, _key, &*result);
-        throwExceptionOnError(status);
-        if (!status.IsNotFound())
+        if (readFromDBUnsafe(i, _key, value))
             return true;
     }
 
     return false;
 }
 
-bool CacheLevelDB::keyExists(const string &_key) {
+bool CacheLevelDB::keyExists(const DBKey &_key) {
 
     shared_lock<shared_mutex> lock(m);
 
@@ -151,22 +339,35 @@ bool CacheLevelDB::keyExists(const string &_key) {
 }
 
 
-void CacheLevelDB::writeString(const string &_key, const string &_value,
+void CacheLevelDB::writeString(const DBKey &_key, const string &_value,
                                bool _overWrite) {
 
+    if (isBatching()) {
+        if ((!_overWrite) && keyExists(_key)) {
+            LOG(trace, "Double db entry " + this->prefix + "\n" + _key.toLegacyString());
+            return;
+        }
+        pendingBatch.entries[string(_key.getData(), _key.getSize())] = {_value, _key.getBlockId()};
+        return;
+    }
+
     rotateDBsIfNeeded();
 
     {
         shared_lock<shared_mutex> lock(m);
 
         if ((!_overWrite) && keyExistsUnsafe(_key)) {
-            LOG(trace, "Double db entry " + this->prefix + "\n" + _key);
+            LOG(trace, "Double db entry " + this->prefix + "\n" + _key.toLegacyString());
             return;
         }
 
-        auto status = db.back()->Put(writeOptions, _key, Slice(_value));
+        auto status = db.back()->Put(writeOptions, Slice(_key.getData(), _key.getSize()), Slice(_value));
 
         throwExceptionOnError(status);
+
+        addBlockToRange(LEVELDB_PIECES - 1, _key.getBlockId());
+
+        activeDBSize += _key.getSize() + _value.size();
     }
 }
 
@@ -179,18 +380,26 @@ void CacheLevelDB::writeByteArray(const char *_key, size_t _keyLen, const char *
     {
         shared_lock<shared_mutex> lock(m);
 
-        if (keyExistsUnsafe(string(_key))) {
-            LOG(trace, "Double entry written to db");
-            return;
+        string previous;
+
+        for (int i = LEVELDB_PIECES - 1; i >= 0; i--) {
+            auto status = db[i]->Get(readOptions, Slice(_key, _keyLen), &previous);
+            throwExceptionOnError(status);
+            if (!status.IsNotFound()) {
+                LOG(trace, "Double entry written to db");
+                return;
+            }
         }
 
         auto status = db.back()->Put(writeOptions, Slice(_key, _keyLen), Slice(value, _valueLen));
 
         throwExceptionOnError(status);
+
+        activeDBSize += _keyLen + _valueLen;
     }
 }
 
-void CacheLevelDB::writeByteArray(string &_key, ptr<vector<uint8_t>> _data) {
+void CacheLevelDB::writeByteArray(const DBKey &_key, ptr<vector<uint8_t>> _data) {
 
     CHECK_ARGUMENT(_data);
 
@@ -202,8 +411,10 @@ void CacheLevelDB::writeByteArray(string &_key, ptr<vector<uint8_t>> _data) {
 
     {
         shared_lock<shared_mutex> lock(m);
-        auto status = db.back()->Put(writeOptions, Slice(_key), Slice(value, valueLen));
+        auto status = db.back()->Put(writeOptions, Slice(_key.getData(), _key.getSize()), Slice(value, valueLen));
         throwExceptionOnError(status);
+        addBlockToRange(LEVELDB_PIECES - 1, _key.getBlockId());
+        activeDBSize += _key.getSize() + valueLen;
     }
 }
 
@@ -218,23 +429,9 @@ void CacheLevelDB::throwExceptionOnError(Status _status) {
 
 }
 
-ptr<string> CacheLevelDB::readLastKeyInPrefixRange(string &_prefix) {
-
-    ptr<map<string, ptr<string>>> result = nullptr;
+ptr<string> CacheLevelDB::readLastKeyInPrefixRange(const DBKey &_prefix) {
 
-    shared_lock<shared_mutex> lock(m);
-
-    for (int i = LEVELDB_PIECES - 1; i >= 0; i--) {
-        ASSERT(db[i]);
-        auto partialResult = readPrefixRangeFromDBUnsafe(_prefix, db[i], true);
-        if (partialResult) {
-            if (result) {
-                result->insert(partialResult->begin(), partialResult->end());
-            } else {
-                result = partialResult;
-            }
-        }
-    }
+    auto result = readPrefixRange(_prefix);
 
     if (result->empty()) {
         return nullptr;
@@ -245,22 +442,27 @@ ptr<string> CacheLevelDB::readLastKeyInPrefixRange(string &_prefix) {
 }
 
 
-ptr<map<string, ptr<string>>> CacheLevelDB::readPrefixRange(string &_prefix) {
+ptr<map<string, ptr<string>>> CacheLevelDB::readPrefixRange(const DBKey &_prefix) {
 
 
-    ptr<map<string, ptr<string>>> result = nullptr;
+    auto result = make_shared<map<string, ptr<string>>>();
 
     shared_lock<shared_mutex> lock(m);
 
+    // newer dbs are read first, so their entries win
+
     for (int i = LEVELDB_PIECES - 1; i >= 0; i--) {
         ASSERT(db[i]);
-        auto partialResult = readPrefixRangeFromDBUnsafe(_prefix, db[i]);
-        if (partialResult) {
-            if (result) {
-                result->insert(partialResult->begin(), partialResult->end());
-            } else {
-                result = partialResult;
-            }
+        if (!mayContainBlock(i, _prefix.getBlockId()))
+            continue;
+        readPrefixRangeFromDBUnsafe(_prefix, i, *result);
+    }
+
+    if (isBatching()) {
+        Slice prefix(_prefix.getData(), _prefix.getSize());
+        for (auto entry = pendingBatch.entries.lower_bound(prefix.ToString());
+             entry != pendingBatch.entries.end() && Slice(entry->first).starts_with(prefix); entry++) {
+            (*result)[entry->first] = make_shared<string>(entry->second.first);
         }
     }
 
@@ -270,30 +472,95 @@ ptr<map<string, ptr<string>>> CacheLevelDB::readPrefixRange(string &_prefix) {
 
 }
 
-ptr<map<string, ptr<string>>> CacheLevelDB::readPrefixRangeFromDBUnsafe(string &_prefix, ptr<leveldb::DB> _db,
-                                                                        bool _lastOnly) {
+void CacheLevelDB::readPrefixRangeFromDBUnsafe(const DBKey &_prefix, uint64_t _dbIndex,
+                                               map<string, ptr<string>> &_result) {
 
-    CHECK_ARGUMENT(_db);
+    auto dbase = db.at(_dbIndex);
 
-    ptr<map<string, ptr<string>>> result = make_shared<map<string, ptr<string>>>();
+    CHECK_ARGUMENT(dbase);
 
-    auto idb = ptr<Iterator>(_db->NewIterator(readOptions));
+    auto idb = ptr<Iterator>(dbase->NewIterator(readOptions));
 
-    if (_lastOnly) {
-        idb->SeekToLast();
-        if (idb->Valid()) {
-            (*result)[idb->key().ToString()] = make_shared<string>(idb->value().ToString());
-            cerr << idb->key().ToString() << endl;
+    Slice prefix(_prefix.getData(), _prefix.getSize());
+
+    for (idb->Seek(prefix); idb->Valid() && idb->key().starts_with(prefix); idb->Next()) {
+        _result.emplace(idb->key().ToString(), make_shared<string>(idb->value().ToString()));
+    }
+
+    if (!hasLegacyKeys.at(_dbIndex))
+        return;
+
+    // the trailing separator keeps the legacy scan from matching longer numbers
+
+    auto legacyPrefix = _prefix.toLegacyString() + ":";
+
+    DBKey converted;
+
+    for (idb->Seek(legacyPrefix); idb->Valid() && idb->key().starts_with(legacyPrefix); idb->Next()) {
+        if (DBKey::fromLegacyString(idb->key().ToString(), converted)) {
+            _result.emplace(string(converted.getData(), converted.getSize()),
+                            make_shared<string>(idb->value().ToString()));
         }
-        return result;
     }
+}
+
+
+bool CacheLevelDB::isBatching() const {
+    return pendingBatch.owner == this;
+}
+
+void CacheLevelDB::startBatch() {
+    CHECK_STATE(pendingBatch.owner == nullptr || isBatching());
+    pendingBatch.owner = this;
+}
+
+void CacheLevelDB::flushBatch() {
+
+    if (!isBatching() || pendingBatch.entries.empty())
+        return;
+
+    rotateDBsIfNeeded();
 
-    for (idb->Seek(_prefix); idb->Valid() && idb->key().starts_with(_prefix); idb->Next()) {
-        (*result)[idb->key().ToString()] = make_shared<string>(idb->value().ToString());
+    {
+        shared_lock<shared_mutex> lock(m);
+
+        leveldb::WriteBatch batch;
+        uint64_t batchSize = 0;
+
+        for (auto &&entry : pendingBatch.entries) {
+            batch.Put(entry.first, entry.second.first);
+            batchSize += entry.first.size() + entry.second.first.size();
+        }
+
+        throwExceptionOnError(db.back()->Write(writeOptions, &batch));
+
+        for (auto &&entry : pendingBatch.entries) {
+            addBlockToRange(LEVELDB_PIECES - 1, entry.second.second);
+        }
+
+        activeDBSize += batchSize;
     }
 
+    pendingBatch.entries.clear();
+}
 
-    return result;
+void CacheLevelDB::commitBatch() {
+
+    if (!isBatching())
+        return;
+
+    flushBatch();
+
+    pendingBatch.owner = nullptr;
+}
+
+void CacheLevelDB::abortBatch() {
+
+    if (!isBatching())
+        return;
+
+    pendingBatch.entries.clear();
+    pendingBatch.owner = nullptr;
 }
 
 
@@ -318,30 +585,41 @@ uint64_t CacheLevelDB::visitKeys(CacheLevelDB::KeyVisitor *_visitor, uint64_t _m
 }
 
 
-DB *CacheLevelDB::openDB(uint64_t _index) {
+ptr<leveldb::DB> CacheLevelDB::openDB(uint64_t _index) {
 
     try {
         leveldb::DB *dbase = nullptr;
 
-        static leveldb::Options options;
+        leveldb::Options options;
         options.create_if_missing = true;
+        options.block_cache = blockCache.get();
+        options.write_buffer_size = profile.getWriteBufferSize();
+        options.max_open_files = profile.getMaxOpenFiles();
+        options.compression = profile.isCompression() ? kSnappyCompression : kNoCompression;
+        // bloom filters let lookups of missing keys skip most table reads
+        options.filter_policy = filterPolicy.get();
+        options.block_size = profile.getBlockSize();
 
         ASSERT2(leveldb::DB::Open(options, path_to_index(_index),
                                   &dbase).ok(),
                 "Unable to open database");
-        return dbase;
+
+        auto cache = blockCache;
+        auto filter = filterPolicy;
+
+        return shared_ptr<leveldb::DB>(dbase, [cache, filter](leveldb::DB *_db) {
+            delete _db;
+        });
 
     } catch (ExitRequestedException &e) { throw; }
     catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
     }
-
 }
 
-
 CacheLevelDB::CacheLevelDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
-                           bool _isDuplicateAddOK)
-        : nodeId(_nodeId),
+                           const LevelDBProfile &_profile, bool _isDuplicateAddOK)
+        : profile(_profile), nodeId(_nodeId),
           prefix(_prefix),
           totalSigners(_sChain->getTotalSigners()),
           requiredSigners(_sChain->getRequiredSigners()),
@@ -358,6 +636,15 @@ CacheLevelDB::CacheLevelDB(Schain *_sChain, string &_dirName, string &_prefix, n
 
     CHECK_ARGUMENT(_maxDBSize != 0);
 
+    // 0 leaves LevelDB defaults in place
+    if (profile.getBlockCacheSize() > 0) {
+        blockCache = ptr<leveldb::Cache>(NewLRUCache(profile.getBlockCacheSize()));
+    }
+
+    if (profile.getFilterBits() > 0) {
+        filterPolicy = ptr<const FilterPolicy>(NewBloomFilterPolicy(profile.getFilterBits()));
+    }
+
     highestDBIndex = findMaxMinDBIndex().first;
 
     if (highestDBIndex < LEVELDB_PIECES) {
@@ -366,11 +653,14 @@ CacheLevelDB::CacheLevelDB(Schain *_sChain, string &_dirName, string &_prefix, n
 
 
     for (auto i = highestDBIndex - LEVELDB_PIECES + 1; i <= highestDBIndex; i++) {
-        leveldb::DB *dbase = openDB(i);
-        db.push_back(shared_ptr<leveldb::DB>(dbase));
+        db.push_back(openDB(i));
+        initLegacyKeys(db.size() - 1);
+        initBlockRange(db.size() - 1);
     }
 
     verify();
+
+    activeDBSize = getActiveDBSize();
 }
 
 CacheLevelDB::~CacheLevelDB() {
@@ -409,6 +699,18 @@ uint64_t CacheLevelDB::getActiveDBSize() {
 }
 
 
+uint64_t CacheLevelDB::getCachedActiveDBSize() const {
+    return activeDBSize;
+}
+
+void CacheLevelDB::refreshActiveDBSize() {
+
+    shared_lock<shared_mutex> lock(m);
+
+    activeDBSize = getActiveDBSize();
+}
+
+
 std::pair<uint64_t, uint64_t> CacheLevelDB::findMaxMinDBIndex() {
 
     vector<path> dirs;
@@ -420,7 +722,7 @@ std::pair<uint64_t, uint64_t> CacheLevelDB::findMaxMinDBIndex() {
     size_t offset = string("db.").size();
 
     for (auto &path : dirs) {
-        if (is_directory(path)) {
+        if (is_directory(path) && !exists(path / PREOPENED_DB_MARKER)) {
             auto fileName = path.filename().string();
             if (fileName.find("db.") == 0) {
                 auto index = fileName.substr(offset);
@@ -441,60 +743,181 @@ std::pair<uint64_t, uint64_t> CacheLevelDB::findMaxMinDBIndex() {
     return {maxIndex, minIndex};
 }
 
+void CacheLevelDB::preOpenNextDB() {
+
+    lock_guard<mutex> nextLock(nextDBMutex);
+
+    auto index = highestDBIndex + 1;
+
+    if (nextDB && nextDBIndex == index)
+        return;
+
+    path dbPath(path_to_index(index));
+    create_directory(dbPath);
+
+    // the marker keeps a restart from taking the empty db for the active one
+    std::ofstream marker((dbPath / PREOPENED_DB_MARKER).string());
+    marker.close();
+
+    nextDB = openDB(index);
+    nextDBIndex = index;
+    nextDBOpened = true;
+}
+
 void CacheLevelDB::rotateDBsIfNeeded() {
 
     try {
 
+        if (!nextDBOpened && activeDBSize > maxDBSize / 100 * PREOPEN_DB_PERCENT) {
+            preOpenNextDB();
+        }
 
-        if (getActiveDBSize() <= maxDBSize)
+        if (activeDBSize <= maxDBSize)
             return;
 
+        uint64_t index;
 
         {
-            lock_guard<shared_mutex> lock(m);
+            shared_lock<shared_mutex> lock(m);
 
-            if (getActiveDBSize() <= maxDBSize)
-                return;
+            // the write counter does not account for compression and compaction,
+            // so confirm on disk before rotating
 
-            LOG(info, "Rotating db");
+            index = highestDBIndex;
 
-            auto newDB = openDB(highestDBIndex + 1);
+            auto diskSize = getActiveDBSize();
 
-            for (int i = 1; i < LEVELDB_PIECES; i++) {
-                db.at(i - 1) = nullptr;
-                db.at(i - 1) = db.at(i);
+            if (diskSize <= maxDBSize) {
+                activeDBSize = diskSize;
+                return;
             }
+        }
+
+        preOpenNextDB();
 
-            db[LEVELDB_PIECES - 1] = shared_ptr<leveldb::DB>(newDB);
+        ptr<leveldb::DB> evictedDB;
+        uint64_t stallUs;
 
-            highestDBIndex++;
+        {
+            lock_guard<mutex> nextLock(nextDBMutex);
 
-            uint64_t minIndex;
+            auto start = chrono::steady_clock::now();
 
-            while ((minIndex = findMaxMinDBIndex().second) + LEVELDB_PIECES <= highestDBIndex) {
+            {
+                lock_guard<shared_mutex> lock(m);
 
-                if (minIndex == 0) {
+                // another thread rotated first
+                if (highestDBIndex != index)
                     return;
-                }
 
-                auto dbName = path_to_index(minIndex);
-                try {
+                CHECK_STATE(nextDB && nextDBIndex == index + 1);
+
+                evictedDB = db.front();
 
-                    boost::filesystem::remove_all(path(dbName));
-                } catch (Exception &e) {
-                    LOG(err, "Could not remove db:" + dbName);
+                for (int i = 1; i < LEVELDB_PIECES; i++) {
+                    db.at(i - 1) = db.at(i);
+                    minBlockIDs.at(i - 1) = minBlockIDs.at(i).load();
+                    maxBlockIDs.at(i - 1) = maxBlockIDs.at(i).load();
+                    hasLegacyKeys.at(i - 1) = hasLegacyKeys.at(i);
                 }
+
+                db[LEVELDB_PIECES - 1] = nextDB;
+                minBlockIDs.at(LEVELDB_PIECES - 1) = UINT64_MAX;
+                maxBlockIDs.at(LEVELDB_PIECES - 1) = 0;
+                hasLegacyKeys.at(LEVELDB_PIECES - 1) = false;
+
+                nextDB = nullptr;
+                nextDBOpened = false;
+
+                remove(path(path_to_index(nextDBIndex)) / PREOPENED_DB_MARKER);
+
+                highestDBIndex++;
+
+                activeDBSize = 0;
+
+                verify();
             }
 
-            verify();
+            stallUs = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
         }
 
+        rotationCount++;
+        lastRotationStallUs = stallUs;
+        totalRotationStallUs += stallUs;
+
+        LOG(info, "Rotated db " + dirname + " to " + to_string(index + 1) + ", stall us:" + to_string(stallUs));
+
+        deleteDBsInBackground(evictedDB, dirname, index + 1 - LEVELDB_PIECES);
+
     } catch (ExitRequestedException &e) { throw; }
     catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
     }
 }
 
+void CacheLevelDB::deleteDBsInBackground(ptr<leveldb::DB> _evictedDB, const string &_dirName, uint64_t _maxIndex) {
+
+    // leaked on purpose, so that the detached thread never outlives them
+    static auto *deletionMutex = new mutex();
+    static auto *deletionCond = new condition_variable();
+    static auto *deletions = new queue<tuple<ptr<leveldb::DB>, string, uint64_t>>();
+    static once_flag threadStarted;
+
+    call_once(threadStarted, []() {
+        thread([]() {
+            setpriority(PRIO_PROCESS, 0, 19);
+
+            while (true) {
+
+                tuple<ptr<leveldb::DB>, string, uint64_t> deletion;
+
+                {
+                    unique_lock<mutex> lock(*deletionMutex);
+                    deletionCond->wait(lock, []() { return !deletions->empty(); });
+                    deletion = deletions->front();
+                    deletions->pop();
+                }
+
+                // closing the db waits for its compactions to finish
+                get<0>(deletion) = nullptr;
+
+                try {
+                    for (auto &&entry : directory_iterator(path(get<1>(deletion)))) {
+                        auto fileName = entry.path().filename().string();
+                        if (fileName.find("db.") != 0)
+                            continue;
+                        auto index = strtoull(fileName.substr(string("db.").size()).c_str(), nullptr, 10);
+                        if (index != 0 && index <= get<2>(deletion)) {
+                            remove_all(entry.path());
+                        }
+                    }
+                } catch (exception &e) {
+                    LOG(err, "Could not remove dbs in " + get<1>(deletion) + ":" + e.what());
+                }
+            }
+        }).detach();
+    });
+
+    {
+        lock_guard<mutex> lock(*deletionMutex);
+        deletions->emplace(_evictedDB, _dirName, _maxIndex);
+    }
+
+    deletionCond->notify_one();
+}
+
+uint64_t CacheLevelDB::getRotationCount() const {
+    return rotationCount;
+}
+
+uint64_t CacheLevelDB::getLastRotationStallUs() const {
+    return lastRotationStallUs;
+}
+
+uint64_t CacheLevelDB::getTotalRotationStallUs() const {
+    return totalRotationStallUs;
+}
+
 
 bool CacheLevelDB::isEnough(block_id _blockID) {
     return readCount(_blockID) >= requiredSigners;
@@ -503,127 +926,130 @@ bool CacheLevelDB::isEnough(block_id _blockID) {
 
 uint64_t CacheLevelDB::readCount(block_id _blockId) {
 
-    auto counterKey = createCounterKey(_blockId);
+    LOCK(setLocks.at((uint64_t) _blockId % SET_LOCK_STRIPES));
 
-    auto countString = readString(counterKey);
+    auto result = getBlockSetUnsafe(_blockId)->count;
 
-    if (countString == nullptr) {
-        return 0;
-    }
+    CHECK_STATE(result <= totalSigners);
 
-    try {
-        auto result = stoull(*countString, NULL, 10);
+    return result;
+}
+
+
+CacheLevelDB::BlockSet::BlockSet(uint64_t _totalSigners) : added(_totalSigners + 1, false),
+                                                          values(make_shared<map<schain_index, ptr<string>>>()) {}
+
+
+ptr<CacheLevelDB::BlockSet> CacheLevelDB::getBlockSetUnsafe(block_id _blockId) {
+
+    auto &stripe = blockSets.at((uint64_t) _blockId % SET_LOCK_STRIPES);
+
+    auto it = stripe.find(_blockId);
 
-        CHECK_STATE(result <= totalSigners);
+    if (it != stripe.end())
+        return it->second;
 
-        return result;
+    auto blockSet = rebuildBlockSet(_blockId);
 
-    } catch (...) {
-        LOG(err, "Incorrect value in LevelDB:" + *countString);
-        return 0;
+    // keep the most recent blocks, older ones are rebuilt from the db if they are needed again.
+    // evict first, so that a set older than everything cached is not evicted right away
+    if (stripe.size() >= MAX_CACHED_BLOCK_SETS / SET_LOCK_STRIPES) {
+        stripe.erase(stripe.begin());
     }
-}
 
-ptr<map<schain_index, ptr<string>>>
-CacheLevelDB::writeStringToSet(const string &_value, block_id _blockId, schain_index _index) {
-    return writeByteArrayToSet(_value.data(), _value.size(), _blockId,
-                               _index);
+    stripe[_blockId] = blockSet;
+
+    return blockSet;
 }
 
 
-ptr<map<schain_index, ptr<string>>>
-CacheLevelDB::writeByteArrayToSet(const char *_value, uint64_t _valueLen, block_id _blockId, schain_index _index) {
+ptr<CacheLevelDB::BlockSet> CacheLevelDB::rebuildBlockSet(block_id _blockId) {
 
-    rotateDBsIfNeeded();
-    {
+    auto blockSet = make_shared<BlockSet>(totalSigners);
 
-        shared_lock<shared_mutex> lock(m);
+    auto prefix = createKey(_blockId);
+
+    auto entries = readPrefixRange(prefix);
+
+    for (auto &&entry : *entries) {
+
+        if (DBKey::getFieldCount(entry.first) != prefix.getFieldCount() + 1)
+            continue;
 
-        return writeByteArrayToSetUnsafe(_value, _valueLen, _blockId, _index);
+        auto index = DBKey::getField(entry.first, prefix.getFieldCount());
 
+        if (index == 0 || index > totalSigners || blockSet->added.at(index))
+            continue;
+
+        blockSet->added.at(index) = true;
+        blockSet->count++;
+        (*blockSet->values)[schain_index(index)] = entry.second;
+    }
+
+    // the complete set has already been returned before the restart
+    if (blockSet->count >= requiredSigners) {
+        blockSet->values = nullptr;
     }
 
+    return blockSet;
 }
 
 
 ptr<map<schain_index, ptr<string>>>
-CacheLevelDB::writeByteArrayToSetUnsafe(const char *_value, uint64_t _valueLen, block_id _blockId,
-                                        schain_index _index) {
+CacheLevelDB::writeStringToSet(const string &_value, block_id _blockId, schain_index _index) {
+    return writeByteArrayToSet(_value.data(), _value.size(), _blockId,
+                               _index);
+}
 
 
+ptr<map<schain_index, ptr<string>>>
+CacheLevelDB::writeByteArrayToSet(const char *_value, uint64_t _valueLen, block_id _blockId, schain_index _index) {
 
-    assert(_index > 0 && _index <= totalSigners);
+    CHECK_ARGUMENT(_index > 0 && _index <= totalSigners);
 
+    rotateDBsIfNeeded();
 
-    string entryKey = createSetKey(_blockId, _index);
+    LOCK(setLocks.at((uint64_t) _blockId % SET_LOCK_STRIPES));
 
+    auto blockSet = getBlockSetUnsafe(_blockId);
 
-    if (keyExistsUnsafe(entryKey)) {
+    if (blockSet->added.at((uint64_t) _index)) {
         if (!isDuplicateAddOK)
             LOG(trace, "Double db entry " + this->prefix + "\n" + to_string(_blockId) + ":" + to_string(_index));
         return nullptr;
     }
 
-    uint64_t count = 0;
-
-    ptr<leveldb::DB> containingDb = nullptr;
-    auto result = make_shared<string>();
+    {
+        shared_lock<shared_mutex> lock(m);
 
-    auto counterKey = createCounterKey(_blockId);
+        auto entryKey = createSetKey(_blockId, _index);
 
-    for (int i = LEVELDB_PIECES - 1; i >= 0; i--) {
-        ASSERT(db[i] != nullptr);
-        auto status = db[i]->Get(readOptions, counterKey, &*result);
+        auto status = db.back()->Put(writeOptions, Slice(entryKey.getData(), entryKey.getSize()),
+                                     Slice(_value, _valueLen));
         throwExceptionOnError(status);
-        if (!status.IsNotFound()) {
-            containingDb = db[i];
-            break;
-        }
-    }
 
-    if (containingDb != nullptr) {
-        try {
-            count = stoull(*result, NULL, 10);
-        } catch (...) {
-            LOG(err, "Incorrect value in LevelDB:" + *result);
-            return 0;
-        }
-    } else {
-        containingDb = db.back();
-    }
-    {
+        addBlockToRange(LEVELDB_PIECES - 1, _blockId);
 
-        leveldb::WriteBatch batch;
-        count++;
-
-        batch.Put(counterKey, to_string(count));
-        batch.Put(entryKey, Slice(_value, _valueLen));
-        CHECK_STATE2(containingDb->Write(writeOptions, &batch).ok(), "Could not write LevelDB");
+        activeDBSize += entryKey.getSize() + _valueLen;
     }
 
+    blockSet->added.at((uint64_t) _index) = true;
+    blockSet->count++;
 
-    if (count != requiredSigners) {
+    if (blockSet->count > requiredSigners) {
         return nullptr;
     }
 
+    (*blockSet->values)[_index] = make_shared<string>(_value, _valueLen);
 
-    auto enoughSet = make_shared<map<schain_index, ptr<string>>>();
-
-    for (uint64_t i = 1; i <= totalSigners; i++) {
-        auto key = createSetKey(_blockId, schain_index(i));
-        auto entry = readStringUnsafe(key);
-
-        if (entry != nullptr)
-            (*enoughSet)[schain_index(i)] = entry;
-        if (enoughSet->size() == requiredSigners) {
-            break;
-        }
+    if (blockSet->count < requiredSigners) {
+        return nullptr;
     }
 
-    assert(enoughSet->size() == requiredSigners);
+    auto enoughSet = blockSet->values;
+    blockSet->values = nullptr;
 
     return enoughSet;
-
 }
 
 void CacheLevelDB::verify() {
@@ -27,12 +27,18 @@
 
 #include "thirdparty/lrucache.hpp"
 #include "SkaleCommon.h"
+#include "DBKey.h"
+#include "LevelDBProfile.h"
 
 class Schain;
 
 namespace leveldb {
     class DB;
 
+    class Cache;
+
+    class FilterPolicy;
+
     class Status;
 
     class Slice;
@@ -41,6 +47,11 @@ namespace leveldb {
 
 #define LEVELDB_PIECES 4
 
+#define SET_LOCK_STRIPES 16
+
+// the next db is opened once the active db reaches this percentage of maxDBSize
+#define PREOPEN_DB_PERCENT 75
+
 
 
 class CacheLevelDB {
@@ -48,8 +59,30 @@ class CacheLevelDB {
 
     void verify();
 
+    LevelDBProfile profile;
+
+    // shared by the shards; each open shard holds a reference, so they outlive it
+    ptr<leveldb::Cache> blockCache;
+    ptr<const leveldb::FilterPolicy> filterPolicy;
+
+
+    // signers added to the set of a block; values are kept until the set reaches requiredSigners
+    class BlockSet {
+    public:
+        explicit BlockSet(uint64_t _totalSigners);
+
+        vector<bool> added;
+        uint64_t count = 0;
+        ptr<map<schain_index, ptr<string>>> values;
+    };
+
+    // sets of recent blocks, striped by block id so that writes for different blocks do not contend
+    array<recursive_mutex, SET_LOCK_STRIPES> setLocks;
+    array<map<block_id, ptr<BlockSet>>, SET_LOCK_STRIPES> blockSets;
+
+    ptr<BlockSet> getBlockSetUnsafe(block_id _blockId);
 
-    ptr<map<schain_index, ptr<string>>> writeByteArrayToSetUnsafe(const char *_value, uint64_t _valueLen, block_id _blockId, schain_index _index);
+    ptr<BlockSet> rebuildBlockSet(block_id _blockId);
 
 protected:
 
@@ -57,9 +90,46 @@ protected:
     uint64_t  highestDBIndex = 0;
     shared_mutex m;
 
+    // min and max block ids written to each db, used to skip dbs on lookups
+    array<atomic<uint64_t>, LEVELDB_PIECES> minBlockIDs;
+    array<atomic<uint64_t>, LEVELDB_PIECES> maxBlockIDs;
+
+    // dbs created before the binary key format, looked up with "1.0" string keys as a fallback
+    array<bool, LEVELDB_PIECES> hasLegacyKeys;
+
+    // approximate size of the active db, incremented on each write and periodically
+    // refreshed from disk by refreshActiveDBSize()
+    atomic<uint64_t> activeDBSize = 0;
+
     uint64_t totalSigners;
     uint64_t requiredSigners;
 
+    // string writes of the thread that started a batch, kept in memory until flushBatch()
+    struct PendingBatch {
+        CacheLevelDB *owner = nullptr;
+        map<string, pair<string, block_id>> entries;
+    };
+
+    static thread_local PendingBatch pendingBatch;
+
+    // db opened ahead of rotation; guarded by nextDBMutex, which is also held while rotating
+    mutex nextDBMutex;
+    ptr<leveldb::DB> nextDB;
+    uint64_t nextDBIndex = 0;
+    // lets writes skip nextDBMutex once the next db is open
+    atomic<bool> nextDBOpened = false;
+
+    atomic<uint64_t> rotationCount = 0;
+    atomic<uint64_t> lastRotationStallUs = 0;
+    atomic<uint64_t> totalRotationStallUs = 0;
+
+    void preOpenNextDB();
+
+    // closes the evicted db and removes dbs up to _maxIndex on a low priority background thread
+    static void deleteDBsInBackground(ptr<leveldb::DB> _evictedDB, const string &_dirName, uint64_t _maxIndex);
+
+    bool isBatching() const;
+
 
     node_id nodeId;
     string prefix;
@@ -70,10 +140,18 @@ protected:
 
 
 
-    ptr<string> readString(string &_key);
-    ptr<string> readStringUnsafe(string &_key);
+    ptr<string> readString(const DBKey &_key);
+    ptr<string> readStringUnsafe(const DBKey &_key);
+
+    bool readFromDBUnsafe(uint64_t _dbIndex, const DBKey &_key, string &_value);
+
+    // appends the value to _buffer straight from LevelDB memory pinned by an iterator,
+    // returns false if the key does not exist
+    bool appendValue(const DBKey &_key, vector<uint8_t> &_buffer);
 
-    void writeString(const string &key1, const string &value1, bool overWrite = false);
+    bool appendValueFromDBUnsafe(uint64_t _dbIndex, const leveldb::Slice &_key, vector<uint8_t> &_buffer);
+
+    void writeString(const DBKey &_key, const string &_value, bool _overWrite = false);
 
     ptr<map<schain_index, ptr<string>>>
     writeStringToSet(const string &_value, block_id _blockId, schain_index _index);
@@ -83,25 +161,33 @@ protected:
 
     void writeByteArray(const char *_key, size_t _keyLen, const char *value,
                         size_t _valueLen);
-    void writeByteArray(string &_key, ptr<vector<uint8_t>> _data);
+    void writeByteArray(const DBKey &_key, ptr<vector<uint8_t>> _data);
 
 
-    ptr<string> createKey(block_id _blockId);
+    DBKey createKey(block_id _blockId);
 
-    ptr<string> createKey(block_id _blockId, schain_index _proposerIndex);
+    DBKey createKey(block_id _blockId, schain_index _proposerIndex);
 
-    ptr<string> createKey(const block_id _blockId, uint64_t _counter);
+    DBKey createKey(const block_id _blockId, uint64_t _counter);
 
-    ptr<string>
+    DBKey
     createKey(const block_id &_blockId, const schain_index &_proposerIndex, const bin_consensus_round &_round);
 
-    string createSetKey(block_id _blockId, schain_index _index);
+    DBKey createSetKey(block_id _blockId, schain_index _index);
+
+    bool keyExists(const DBKey &_key);
+
+    bool keyExistsUnsafe(const DBKey &_key);
+
+    bool mayContainBlock(uint64_t _dbIndex, block_id _blockId);
+
+    void addBlockToRange(uint64_t _dbIndex, block_id _blockId);
 
-    string createCounterKey(block_id _block_id);
+    void initBlockRange(uint64_t _dbIndex);
 
-    bool keyExists(const string &_key);
+    void extendBlockRangeFromDB(uint64_t _dbIndex, const DBKey &_prefix, const DBKey &_limit);
 
-    bool keyExistsUnsafe(const string &_key);
+    void initLegacyKeys(uint64_t _dbIndex);
 
     bool keyExistsInSet(block_id _blockId, schain_index _index);
 
@@ -109,7 +195,7 @@ protected:
 
     void rotateDBsIfNeeded();
 
-    leveldb::DB *openDB(uint64_t _index);
+    ptr<leveldb::DB> openDB(uint64_t _index);
 
     uint64_t readCount(block_id _blockId);
 
@@ -118,14 +204,12 @@ protected:
 
 
     CacheLevelDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
-                 bool _isDuplicateAddOK = false);
+                 const LevelDBProfile &_profile, bool _isDuplicateAddOK = false);
 
-    ptr<map<string, ptr<string>>> readPrefixRangeFromDBUnsafe(string &_prefix, ptr<leveldb::DB> _db, bool lastOnly = false);
+    void readPrefixRangeFromDBUnsafe(const DBKey &_prefix, uint64_t _dbIndex, map<string, ptr<string>> &_result);
 
 public:
 
-    virtual const string getFormatVersion() = 0;
-
     void throwExceptionOnError(leveldb::Status result);
 
 
@@ -149,10 +233,32 @@ public:
 
     uint64_t getActiveDBSize();
 
-    ptr<map<string, ptr<string>>> readPrefixRange(string &_prefix);
+    uint64_t getCachedActiveDBSize() const;
+
+    void refreshActiveDBSize();
+
+    uint64_t getRotationCount() const;
+
+    uint64_t getLastRotationStallUs() const;
+
+    uint64_t getTotalRotationStallUs() const;
+
+    // string writes of the calling thread are collected and written with a single
+    // WriteBatch on flushBatch() or commitBatch(); reads of the thread see them
+    void startBatch();
+
+    void flushBatch();
+
+    void commitBatch();
+
+    // drops writes that are still pending and ends the batch
+    void abortBatch();
+
+    // keys of the result are binary keys; entries of legacy dbs are converted
+    ptr<map<string, ptr<string>>> readPrefixRange(const DBKey &_prefix);
 
 
-    ptr<string> readLastKeyInPrefixRange(string &_prefix);
+    ptr<string> readLastKeyInPrefixRange(const DBKey &_prefix);
 private:
     std::string path_to_index(uint64_t index);
 };
@@ -32,14 +32,10 @@
 
 
 CommittedTransactionDB::CommittedTransactionDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId,
-                                               uint64_t _maxDBSize) : CacheLevelDB(_sChain, _dirName, _prefix, _nodeId,
-                                                                                   _maxDBSize, false) {}
+                                               uint64_t _maxDBSize, const LevelDBProfile &_profile)
+        : CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, _profile, false) {}
 
 
-const string CommittedTransactionDB::getFormatVersion() {
-    return "1.0";
-}
-
 
 void CommittedTransactionDB::writeCommittedTransaction(ptr<Transaction> _t, __uint64_t _committedTransactionCounter) {
 
@@ -49,7 +45,7 @@ void CommittedTransactionDB::writeCommittedTransaction(ptr<Transaction> _t, __ui
     auto valueLen = sizeof(_committedTransactionCounter);
     writeByteArray(key, keyLen, value, valueLen);
 
-    static auto key1 = getFormatVersion() + string(":transactions");
+    static auto key1 = DBKey().addTag(DBKey::TRANSACTIONS);
     auto value1 = to_string(_committedTransactionCounter);
     writeString(key1, value1);
 
@@ -31,13 +31,11 @@ class Transaction;
 
 class CommittedTransactionDB : public CacheLevelDB {
 
-    const string getFormatVersion();
-
 
 public:
 
     CommittedTransactionDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId,
-                           uint64_t _maxDBSize);
+                           uint64_t _maxDBSize, const LevelDBProfile &_profile);
 
     void writeCommittedTransaction(ptr<Transaction> _t, __uint64_t _committedTransactionCounter);
 
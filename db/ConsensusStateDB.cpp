@@ -33,83 +33,73 @@
 
 
 ConsensusStateDB::ConsensusStateDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId,
-                                   uint64_t _maxDBSize) : CacheLevelDB(_sChain, _dirName, _prefix, _nodeId,
-                                                                       _maxDBSize, false) {}
+                                   uint64_t _maxDBSize, const LevelDBProfile &_profile)
+        : CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, _profile, false) {}
 
 
-const string ConsensusStateDB::getFormatVersion() {
-    return "1.0";
-}
-
 
-ptr<string> ConsensusStateDB::createCurrentRoundKey(block_id _blockId, schain_index _proposerIndex) {
+DBKey ConsensusStateDB::createCurrentRoundKey(block_id _blockId, schain_index _proposerIndex) {
 
     auto key = createKey(_blockId, _proposerIndex);
-    key->append(":cr");
+    key.addTag(DBKey::CURRENT_ROUND);
     return key;
 }
 
-ptr<string> ConsensusStateDB::createDecidedRoundKey(block_id _blockId, schain_index _proposerIndex) {
+DBKey ConsensusStateDB::createDecidedRoundKey(block_id _blockId, schain_index _proposerIndex) {
     auto key = createKey(_blockId, _proposerIndex);
-    key->append(":dr");
+    key.addTag(DBKey::DECIDED_ROUND);
     return key;
 
 }
 
-ptr<string> ConsensusStateDB::createDecidedValueKey(block_id _blockId, schain_index _proposerIndex) {
+DBKey ConsensusStateDB::createDecidedValueKey(block_id _blockId, schain_index _proposerIndex) {
     auto key = createKey(_blockId, _proposerIndex);
-    key->append(":dv");
+    key.addTag(DBKey::DECIDED_VALUE);
     return key;
 }
 
 
-ptr<string>
+DBKey
 ConsensusStateDB::createProposalKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r) {
     auto key = createKey(_blockId, _proposerIndex);
-    key->append(":prp:").append(to_string(_r));
+    key.addTag(DBKey::PROPOSAL).add((uint64_t) _r);
     return key;
 }
 
-ptr<string>
+DBKey
 ConsensusStateDB::createBVBVoteKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
                                    schain_index _voterIndex, bin_consensus_value _v) {
     auto key = createKey(_blockId, _proposerIndex);
-    key->
-            append(":bvb:").append(to_string(_r)).append(":").append(to_string(_voterIndex)).append(":").append(
-            to_string(
-                    (uint32_t) (uint8_t) _v));
+    key.addTag(DBKey::BVB_VOTE).add((uint64_t) _r).add((uint64_t) _voterIndex).add((uint8_t) _v);
     return key;
 }
 
 
-ptr<string> ConsensusStateDB::createBinValueKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
-                                                bin_consensus_value _v) {
+DBKey ConsensusStateDB::createBinValueKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
+                                          bin_consensus_value _v) {
     auto key = createKey(_blockId, _proposerIndex);
-    key->append(":bin:").append(to_string(_r)).append(":").append(to_string((uint32_t) (uint8_t) _v));
+    key.addTag(DBKey::BIN_VALUE).add((uint64_t) _r).add((uint8_t) _v);
     return key;
 }
 
-ptr<string>
+DBKey
 ConsensusStateDB::createAUXVoteKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
                                    schain_index _voterIndex, bin_consensus_value _v) {
 
     auto key = createKey(_blockId, _proposerIndex);
-    key->
-            append(":aux:").append(to_string(_r)).append(":").append(to_string(_voterIndex)).append(":").append(
-            to_string(
-                    (uint32_t) (uint8_t) _v));
+    key.addTag(DBKey::AUX_VOTE).add((uint64_t) _r).add((uint64_t) _voterIndex).add((uint8_t) _v);
     return key;
 }
 
 
 void ConsensusStateDB::writeCR(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r) {
     auto key = createCurrentRoundKey(_blockId, _proposerIndex);
-    writeString(*key, to_string((uint64_t) _r), true);
+    writeString(key, to_string((uint64_t) _r), true);
 }
 
 bin_consensus_round ConsensusStateDB::readCR(block_id _blockId, schain_index _proposerIndex) {
     auto key = createCurrentRoundKey(_blockId, _proposerIndex);
-    auto round = readString(*key);
+    auto round = readString(key);
     if (round == nullptr) {
         return 0;
     }
@@ -121,13 +111,13 @@ bin_consensus_round ConsensusStateDB::readCR(block_id _blockId, schain_index _pr
 
 void ConsensusStateDB::writeDR(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r) {
     auto key = createDecidedRoundKey(_blockId, _proposerIndex);
-    writeString(*key, to_string((uint64_t) _r));
+    writeString(key, to_string((uint64_t) _r));
 
 }
 
 pair<bool, bin_consensus_round> ConsensusStateDB::readDR(block_id _blockId, schain_index _proposerIndex) {
     auto key = createDecidedRoundKey(_blockId, _proposerIndex);
-    auto value = readString(*key);
+    auto value = readString(key);
     if (value == nullptr) {
         return {false, 0};
     }
@@ -140,12 +130,12 @@ void ConsensusStateDB::writeDV(block_id _blockId, schain_index _proposerIndex, b
     CHECK_ARGUMENT(_v <= 1)
 
     auto key = createDecidedValueKey(_blockId, _proposerIndex);
-    writeString(*key, to_string((uint32_t) (uint8_t) _v));
+    writeString(key, to_string((uint32_t) (uint8_t) _v));
 }
 
 bin_consensus_value ConsensusStateDB::readDV(block_id _blockId, schain_index _proposerIndex) {
     auto key = createDecidedValueKey(_blockId, _proposerIndex);
-    auto value = readString(*key);
+    auto value = readString(key);
     if (value == nullptr)
         BOOST_THROW_EXCEPTION(InvalidStateException("Missing DV", __CLASS_NAME__));
     uint32_t result;
@@ -158,7 +148,7 @@ void ConsensusStateDB::writePr(block_id _blockId, schain_index _proposerIndex, b
                                bin_consensus_value _v) {
     CHECK_ARGUMENT(_v <= 1)
     auto key = createProposalKey(_blockId, _proposerIndex, _r);
-    writeString(*key, to_string((uint32_t) (uint8_t) _v));
+    writeString(key, to_string((uint32_t) (uint8_t) _v));
 }
 
 
@@ -166,7 +156,7 @@ void ConsensusStateDB::writePr(block_id _blockId, schain_index _proposerIndex, b
 bin_consensus_value ConsensusStateDB::readPR(block_id _blockId, schain_index _proposerIndex,
                                              bin_consensus_round _r) {
     auto key = createProposalKey(_blockId, _proposerIndex, _r);
-    auto value = readString(*key);
+    auto value = readString(key);
     if (value == nullptr)
         BOOST_THROW_EXCEPTION(InvalidStateException("Missing DV", __CLASS_NAME__));
     uint32_t result;
@@ -179,7 +169,7 @@ void ConsensusStateDB::writeBVBVote(block_id _blockId, schain_index _proposerInd
                                     schain_index _voterIndex, bin_consensus_value _v) {
     CHECK_ARGUMENT(_v <= 1)
     auto key = createBVBVoteKey(_blockId, _proposerIndex, _r, _voterIndex, _v);
-    writeString(*key, "");
+    writeString(key, "");
 
 }
 
@@ -187,7 +177,8 @@ pair<ptr<map<bin_consensus_round, set<schain_index>>>,
         ptr<map<bin_consensus_round, set<schain_index>>>>
 ConsensusStateDB::readBVBVotes(block_id _blockId, schain_index _proposerIndex) {
 
-    auto prefix = createKey(_blockId, _proposerIndex)->append(":bvb:");
+    auto prefix = createKey(_blockId, _proposerIndex);
+    prefix.addTag(DBKey::BVB_VOTE);
     auto keysAndValues = readPrefixRange(prefix);
 
     auto trueMap = make_shared<map<bin_consensus_round, set<schain_index>>>();
@@ -199,16 +190,11 @@ ConsensusStateDB::readBVBVotes(block_id _blockId, schain_index _proposerIndex) {
     }
 
     for (auto&& item : *keysAndValues) {
-        CHECK_STATE(item.first.rfind(prefix) == 0);
-        auto info = stringstream(item.first.substr(prefix.size()));
-        uint64_t round;
-        uint64_t voterIndex;
-        uint32_t value;
-        info >> round;
-        CHECK_STATE(info.get() == ':');
-        info >> voterIndex;
-        CHECK_STATE(info.get() == ':');
-        info >> value;
+        CHECK_STATE(prefix.isPrefixOf(item.first.data(), item.first.size()));
+        CHECK_STATE(DBKey::getFieldCount(item.first) == prefix.getFieldCount() + 3);
+        auto round = DBKey::getField(item.first, prefix.getFieldCount());
+        auto voterIndex = DBKey::getField(item.first, prefix.getFieldCount() + 1);
+        auto value = DBKey::getField(item.first, prefix.getFieldCount() + 2);
 
         ptr<map<bin_consensus_round, set<schain_index>>> outputMap;
         outputMap = (value > 0  ? trueMap : falseMap);
@@ -223,7 +209,7 @@ void ConsensusStateDB::writeBinValue(block_id _blockId, schain_index _proposerIn
                                      bin_consensus_value _v) {
     CHECK_ARGUMENT(_v <= 1)
     auto key = createBinValueKey(_blockId, _proposerIndex, _r, _v);
-    writeString(*key, "");
+    writeString(key, "");
 
 }
 
@@ -232,7 +218,8 @@ ConsensusStateDB::readBinValues(block_id _blockId, schain_index _proposerIndex)
 
     auto result = make_shared<map<bin_consensus_round, set<bin_consensus_value>>>();
 
-    auto prefix = createKey(_blockId, _proposerIndex)->append(":bin:");
+    auto prefix = createKey(_blockId, _proposerIndex);
+    prefix.addTag(DBKey::BIN_VALUE);
     auto keysAndValues = readPrefixRange(prefix);
 
     if (keysAndValues == nullptr) {
@@ -240,15 +227,10 @@ ConsensusStateDB::readBinValues(block_id _blockId, schain_index _proposerIndex)
     }
 
     for (auto&& item : *keysAndValues) {
-        CHECK_STATE(item.first.rfind(prefix) == 0);
-
-
-        auto info = stringstream(item.first.substr(prefix.size()));
-        uint64_t round;
-        uint32_t value;
-        info >> round;
-        CHECK_STATE(info.get() == ':');
-        info >> value;
+        CHECK_STATE(prefix.isPrefixOf(item.first.data(), item.first.size()));
+        CHECK_STATE(DBKey::getFieldCount(item.first) == prefix.getFieldCount() + 2);
+        auto round = DBKey::getField(item.first, prefix.getFieldCount());
+        auto value = DBKey::getField(item.first, prefix.getFieldCount() + 1);
         bin_consensus_value b(value > 0 ? 1 : 0);
         (*result)[bin_consensus_round(round)].insert(b);
     }
@@ -260,7 +242,8 @@ ConsensusStateDB::readPRs(block_id _blockId, schain_index _proposerIndex) {
 
     auto result = make_shared<map<bin_consensus_round, bin_consensus_value>>();
 
-    auto prefix = createKey(_blockId, _proposerIndex)->append(":pr:");
+    auto prefix = createKey(_blockId, _proposerIndex);
+    prefix.addTag(DBKey::PROPOSAL);
     auto keysAndValues = readPrefixRange(prefix);
 
     if (keysAndValues == nullptr) {
@@ -268,15 +251,12 @@ ConsensusStateDB::readPRs(block_id _blockId, schain_index _proposerIndex) {
     }
 
     for (auto&& item : *keysAndValues) {
-        CHECK_STATE(item.first.rfind(prefix) == 0);
-
-
-        auto info = stringstream(item.first.substr(prefix.size()));
-        uint64_t round;
+        CHECK_STATE(prefix.isPrefixOf(item.first.data(), item.first.size()));
+        CHECK_STATE(DBKey::getFieldCount(item.first) == prefix.getFieldCount() + 1);
+        auto round = DBKey::getField(item.first, prefix.getFieldCount());
+        CHECK_STATE(item.second);
         uint32_t value;
-        info >> round;
-        CHECK_STATE(info.get() == ':');
-        info >> value;
+        stringstream(*item.second) >> value;
         bin_consensus_value b(value > 0 ? 1 : 0);
         (*result)[bin_consensus_round(round)] = b;
     }
@@ -291,7 +271,7 @@ void ConsensusStateDB::writeAUXVote(block_id _blockId, schain_index _proposerInd
     CHECK_ARGUMENT(_v <= 1);
     CHECK_ARGUMENT(_sigShare);
     auto key = createAUXVoteKey(_blockId, _proposerIndex, _r, _voterIndex, _v);
-    writeString(*key, *_sigShare);
+    writeString(key, *_sigShare);
 
 }
 
@@ -305,7 +285,8 @@ ConsensusStateDB::readAUXVotes(block_id _blockId, schain_index _proposerIndex, p
     auto falseMap = make_shared<map<bin_consensus_round, map<schain_index, ptr<ThresholdSigShare>>>>();
 
 
-    auto prefix = createKey(_blockId, _proposerIndex)->append(":aux:");
+    auto prefix = createKey(_blockId, _proposerIndex);
+    prefix.addTag(DBKey::AUX_VOTE);
     auto keysAndValues = readPrefixRange(prefix);
 
     if (keysAndValues == nullptr) {
@@ -313,16 +294,11 @@ ConsensusStateDB::readAUXVotes(block_id _blockId, schain_index _proposerIndex, p
     }
 
     for (auto&& item : *keysAndValues) {
-        CHECK_STATE(item.first.rfind(prefix) == 0);
-        auto info = stringstream(item.first.substr(prefix.size()));
-        uint64_t round;
-        uint64_t voterIndex;
-        uint32_t value;
-        info >> round;
-        CHECK_STATE(info.get() == ':');
-        info >> voterIndex;
-        CHECK_STATE(info.get() == ':');
-        info >> value;
+        CHECK_STATE(prefix.isPrefixOf(item.first.data(), item.first.size()));
+        CHECK_STATE(DBKey::getFieldCount(item.first) == prefix.getFieldCount() + 3);
+        auto round = DBKey::getField(item.first, prefix.getFieldCount());
+        auto voterIndex = DBKey::getField(item.first, prefix.getFieldCount() + 1);
+        auto value = DBKey::getField(item.first, prefix.getFieldCount() + 2);
 
         ptr<map<bin_consensus_round, map<schain_index, ptr<ThresholdSigShare>>>> outputMap;
         outputMap = (value > 0  ? trueMap : falseMap);
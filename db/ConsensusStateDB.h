@@ -29,34 +29,33 @@
 #include "CacheLevelDB.h"
 
 class CryptoManager;
+class ThresholdSigShare;
 
 class ConsensusStateDB : public CacheLevelDB {
 
-    const string getFormatVersion();
+    DBKey createCurrentRoundKey(block_id _blockId, schain_index _proposerIndex);
 
-    ptr<string> createCurrentRoundKey(block_id _blockId, schain_index _proposerIndex);
+    DBKey createDecidedRoundKey(block_id _blockId, schain_index _proposerIndex);
 
-    ptr<string> createDecidedRoundKey(block_id _blockId, schain_index _proposerIndex);
+    DBKey createDecidedValueKey(block_id _blockId, schain_index _proposerIndex);
 
-    ptr<string> createDecidedValueKey(block_id _blockId, schain_index _proposerIndex);
+    DBKey createProposalKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r);
 
-    ptr<string> createProposalKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r);
+    DBKey createBVBVoteKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
+                           schain_index _voterIndex, bin_consensus_value _v);
 
-    ptr<string> createBVBVoteKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
-                                 schain_index _voterIndex, bin_consensus_value _v);
+    DBKey createBinValueKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
+                            bin_consensus_value _v);
 
-    ptr<string> createBinValueKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
-                                  bin_consensus_value _v);
 
-
-    ptr<string> createAUXVoteKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
-                                 schain_index _voterIndex, bin_consensus_value _v);
+    DBKey createAUXVoteKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
+                           schain_index _voterIndex, bin_consensus_value _v);
 
 
 public:
 
     ConsensusStateDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId,
-                     uint64_t _maxDBSize);
+                     uint64_t _maxDBSize, const LevelDBProfile &_profile);
 
 
     void writeCR(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r);
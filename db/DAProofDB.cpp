@@ -57,14 +57,11 @@
 using namespace std;
 
 
-DAProofDB::DAProofDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize) :
-        CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, false) {
+DAProofDB::DAProofDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                     const LevelDBProfile &_profile) :
+        CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, _profile, false) {
 };
 
-const string DAProofDB::getFormatVersion() {
-    return "1.0";
-}
-
 
 
 bool DAProofDB::haveDAProof(ptr<BlockProposal> _proposal) {
@@ -48,12 +48,11 @@ class DAProofDB : public  CacheLevelDB {
 
 public:
 
-    explicit DAProofDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize);
+    explicit DAProofDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                       const LevelDBProfile &_profile);
 
     ptr<BooleanProposalVector> addDAProof(ptr<DAProof> _daProof);
 
-    const string getFormatVersion();
-
     bool haveDAProof(ptr<BlockProposal> _proposal);
 
     bool isEnoughProofs(block_id _blockID);
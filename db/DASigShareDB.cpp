@@ -55,14 +55,11 @@
 using namespace std;
 
 
-DASigShareDB::DASigShareDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize) :
-        CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize) {
+DASigShareDB::DASigShareDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                           const LevelDBProfile &_profile) :
+        CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, _profile) {
 };
 
-const string DASigShareDB::getFormatVersion() {
-    return "1.0";
-}
-
 
 // return not-null if _sigShare completes sig, null otherwise (both if not enough and too much)
 ptr<DAProof> DASigShareDB::addAndMergeSigShareAndVerifySig(ptr<ThresholdSigShare> _sigShare,
@@ -43,12 +43,12 @@ class DASigShareDB : public  CacheLevelDB {
 
 public:
 
-    explicit DASigShareDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize);
+    explicit DASigShareDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                          const LevelDBProfile &_profile);
 
     ptr<DAProof> addAndMergeSigShareAndVerifySig(ptr<ThresholdSigShare> _sigShare,
                                                  ptr<BlockProposal> _proposal);
 
-    const string getFormatVersion();
 };
 
 
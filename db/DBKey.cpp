@@ -0,0 +1,210 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file DBKey.cpp
+    @author Stan Kladko
+    @date 2019
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/InvalidArgumentException.h"
+#include "exceptions/InvalidStateException.h"
+
+#include "DBKey.h"
+
+
+DBKey::DBKey() {
+    data[0] = FORMAT_VERSION;
+}
+
+DBKey::DBKey(block_id _blockId) : DBKey() {
+    addBlockId(_blockId);
+}
+
+DBKey &DBKey::add(uint64_t _value) {
+
+    CHECK_STATE(fieldCount < MAX_FIELDS);
+
+    auto offset = 1 + fieldCount * FIELD_SIZE;
+
+    for (uint64_t i = 0; i < FIELD_SIZE; i++) {
+        data[offset + i] = (char) (uint8_t) (_value >> (8 * (FIELD_SIZE - 1 - i)));
+    }
+
+    fieldCount++;
+
+    return *this;
+}
+
+DBKey &DBKey::addTag(DBKey::Tag _tag) {
+    return add(_tag);
+}
+
+DBKey &DBKey::addBlockId(block_id _blockId) {
+    CHECK_ARGUMENT((uint64_t) _blockId < TAG_BASE);
+    blockId = _blockId;
+    return add((uint64_t) _blockId);
+}
+
+const char *DBKey::getData() const {
+    return data.data();
+}
+
+uint64_t DBKey::getSize() const {
+    return 1 + fieldCount * FIELD_SIZE;
+}
+
+uint64_t DBKey::getFieldCount() const {
+    return fieldCount;
+}
+
+uint64_t DBKey::getField(uint64_t _index) const {
+    CHECK_ARGUMENT(_index < fieldCount);
+
+    uint64_t result = 0;
+    auto offset = 1 + _index * FIELD_SIZE;
+
+    for (uint64_t i = 0; i < FIELD_SIZE; i++) {
+        result = (result << 8) | (uint8_t) data[offset + i];
+    }
+
+    return result;
+}
+
+block_id DBKey::getBlockId() const {
+    return blockId;
+}
+
+bool DBKey::isPrefixOf(const char *_key, uint64_t _keyLen) const {
+    return _keyLen >= getSize() && memcmp(_key, data.data(), getSize()) == 0;
+}
+
+bool DBKey::isValid(const string &_key) {
+    return _key.size() > 0 && (_key.size() - 1) % FIELD_SIZE == 0 && (uint8_t) _key[0] == FORMAT_VERSION;
+}
+
+uint64_t DBKey::getFieldCount(const string &_key) {
+    CHECK_ARGUMENT(isValid(_key));
+    return (_key.size() - 1) / FIELD_SIZE;
+}
+
+uint64_t DBKey::getField(const string &_key, uint64_t _index) {
+
+    CHECK_ARGUMENT(_index < getFieldCount(_key));
+
+    uint64_t result = 0;
+    auto offset = 1 + _index * FIELD_SIZE;
+
+    for (uint64_t i = 0; i < FIELD_SIZE; i++) {
+        result = (result << 8) | (uint8_t) _key[offset + i];
+    }
+
+    return result;
+}
+
+const char *DBKey::tagToLegacyString(uint64_t _tag) {
+    switch (_tag) {
+        case COUNTER:
+            return "COUNTER";
+        case LAST:
+            return "last";
+        case TRANSACTIONS:
+            return "transactions";
+        case CURRENT_ROUND:
+            return "cr";
+        case DECIDED_ROUND:
+            return "dr";
+        case DECIDED_VALUE:
+            return "dv";
+        case PROPOSAL:
+            return "prp";
+        case BVB_VOTE:
+            return "bvb";
+        case BIN_VALUE:
+            return "bin";
+        case AUX_VOTE:
+            return "aux";
+        default:
+            BOOST_THROW_EXCEPTION(InvalidArgumentException("Unknown key tag:" + to_string(_tag), __CLASS_NAME__));
+    }
+}
+
+uint64_t DBKey::legacyStringToTag(const string &_s) {
+    for (uint64_t tag = COUNTER; tag <= AUX_VOTE; tag++) {
+        if (_s == tagToLegacyString(tag))
+            return tag;
+    }
+    return 0;
+}
+
+string DBKey::toLegacyString() const {
+
+    string result(LEGACY_FORMAT_VERSION);
+
+    for (uint64_t i = 0; i < fieldCount; i++) {
+        auto field = getField(i);
+        result.append(":");
+        if (field >= TAG_BASE) {
+            result.append(tagToLegacyString(field));
+        } else {
+            result.append(to_string(field));
+        }
+    }
+
+    return result;
+}
+
+bool DBKey::fromLegacyString(const string &_legacyKey, DBKey &_result) {
+
+    string versionPrefix = string(LEGACY_FORMAT_VERSION) + ":";
+
+    if (_legacyKey.find(versionPrefix) != 0)
+        return false;
+
+    _result = DBKey();
+
+    stringstream tokens(_legacyKey.substr(versionPrefix.size()));
+    string token;
+
+    while (getline(tokens, token, ':')) {
+
+        if (_result.getFieldCount() >= MAX_FIELDS || token.empty())
+            return false;
+
+        if (all_of(token.begin(), token.end(), ::isdigit)) {
+            auto value = stoull(token);
+            if (value >= TAG_BASE)
+                return false;
+            // the first number of a legacy key, or the one after COUNTER, is the block id
+            if (_result.getBlockId() == 0 &&
+                (_result.getFieldCount() == 0 || _result.getField(_result.getFieldCount() - 1) == COUNTER)) {
+                _result.addBlockId(value);
+            } else {
+                _result.add(value);
+            }
+        } else {
+            auto tag = legacyStringToTag(token);
+            if (tag == 0)
+                return false;
+            _result.addTag((Tag) tag);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,114 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file DBKey.h
+    @author Stan Kladko
+    @date 2019
+*/
+
+#ifndef SKALED_DBKEY_H
+#define SKALED_DBKEY_H
+
+
+// Binary LevelDB key built on the stack. A key is a format version byte followed by
+// fixed-width big-endian 64-bit fields, so keys sort numerically and a prefix of
+// whole fields matches exactly. Tags occupy the upper half of the 64-bit range so
+// they never collide with block ids.
+
+class DBKey {
+
+public:
+
+    static constexpr uint8_t FORMAT_VERSION = 2;
+
+    static constexpr const char *LEGACY_FORMAT_VERSION = "1.0";
+
+    static constexpr uint64_t MAX_FIELDS = 8;
+
+    static constexpr uint64_t FIELD_SIZE = sizeof(uint64_t);
+
+    static constexpr uint64_t MAX_SIZE = 1 + MAX_FIELDS * FIELD_SIZE;
+
+    static constexpr uint64_t TAG_BASE = 0x8000000000000000;
+
+    enum Tag : uint64_t {
+        COUNTER = TAG_BASE + 1,
+        LAST = TAG_BASE + 2,
+        TRANSACTIONS = TAG_BASE + 3,
+        CURRENT_ROUND = TAG_BASE + 4,
+        DECIDED_ROUND = TAG_BASE + 5,
+        DECIDED_VALUE = TAG_BASE + 6,
+        PROPOSAL = TAG_BASE + 7,
+        BVB_VOTE = TAG_BASE + 8,
+        BIN_VALUE = TAG_BASE + 9,
+        AUX_VOTE = TAG_BASE + 10
+    };
+
+private:
+
+    array<char, MAX_SIZE> data;
+
+    uint64_t fieldCount = 0;
+
+    block_id blockId = 0;
+
+    static const char *tagToLegacyString(uint64_t _tag);
+
+    static uint64_t legacyStringToTag(const string &_s);
+
+public:
+
+    DBKey();
+
+    explicit DBKey(block_id _blockId);
+
+    DBKey &add(uint64_t _value);
+
+    DBKey &addTag(Tag _tag);
+
+    DBKey &addBlockId(block_id _blockId);
+
+    const char *getData() const;
+
+    uint64_t getSize() const;
+
+    uint64_t getFieldCount() const;
+
+    uint64_t getField(uint64_t _index) const;
+
+    // 0 if the key is not tied to a block
+    block_id getBlockId() const;
+
+    bool isPrefixOf(const char *_key, uint64_t _keyLen) const;
+
+    string toLegacyString() const;
+
+    static uint64_t getField(const string &_key, uint64_t _index);
+
+    static uint64_t getFieldCount(const string &_key);
+
+    // false for raw keys, such as partial transaction hashes, that may start with the version byte
+    static bool isValid(const string &_key);
+
+    // parses a key written in the "1.0" string format, returns false if it can not be converted
+    static bool fromLegacyString(const string &_legacyKey, DBKey &_result);
+
+};
+
+
+#endif //SKALED_DBKEY_H
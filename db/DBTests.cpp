@@ -27,6 +27,8 @@
 #include "exceptions/ParsingException.h"
 #include "crypto/CryptoManager.h"
 #include "datastructures/CommittedBlock.h"
+#include "datastructures/BlockProposal.h"
+#include "datastructures/TransactionList.h"
 
 #define BOOST_PENDING_INTEGER_LOG2_HPP
 
@@ -40,7 +42,12 @@
 
 #include "chains/Schain.h"
 
+#include "utils/Time.h"
 #include "BlockDB.h"
+#include "BlockProposalDB.h"
+#include "RandomDB.h"
+#include "DBKey.h"
+#include "ConsensusStateDB.h"
 
 
 void test_committed_block_save() {
@@ -59,7 +66,8 @@ void test_committed_block_save() {
 
 
 
-    auto db = make_shared<BlockDB>(sChain.get(), dirName, fileName, node_id(1), 5000000);
+    auto db = make_shared<BlockDB>(sChain.get(), dirName, fileName, node_id(1), 5000000,
+                                   LevelDBProfile::largeValueDefaults());
 
     for (int i = 1; i < 500; i++) {
         auto t = CommittedBlock::createRandomSample(cryptoManager, i, gen, ubyte);
@@ -81,3 +89,261 @@ TEST_CASE("Save/read block", "[block-save-read-db]") {
         test_committed_block_save();
 }
 
+
+
+void test_db_lookup_across_rotations() {
+
+    auto sChain = make_shared<Schain>();
+    static string dirName = "/tmp";
+    static string fileName = "test_db_lookup_across_rotations";
+
+    if (std::system(("rm -rf " + dirName + "/" + fileName).c_str()) != 0) {
+        BOOST_THROW_EXCEPTION(runtime_error("Remove failed"));
+    }
+
+    auto db = make_shared<RandomDB>(sChain.get(), dirName, fileName, node_id(1), 100000,
+                                     LevelDBProfile::smallValueDefaults());
+
+    for (uint64_t i = 1; i <= 20000; i++) {
+        db->writeRandom(block_id(i), schain_index(1), bin_consensus_round(0), i);
+        // recent entries are always in one of the live dbs
+        auto readBack = i > 1000 ? i - 1000 : i;
+        REQUIRE(db->readRandom(block_id(readBack), schain_index(1), bin_consensus_round(0)) == readBack);
+    }
+
+    REQUIRE(db->findMaxMinDBIndex().first > LEVELDB_PIECES);
+}
+
+TEST_CASE("Read values across db rotations", "[db-rotation-lookup]") {
+    SECTION("Test lookups skip dbs that can not contain the block")
+        test_db_lookup_across_rotations();
+}
+
+void test_db_write_throughput(bool _scanDiskOnEachWrite) {
+
+    auto sChain = make_shared<Schain>();
+    static string dirName = "/tmp";
+    static string fileName = "test_db_write_throughput";
+    static const uint64_t WRITES = 100000;
+
+    if (std::system(("rm -rf " + dirName + "/" + fileName).c_str()) != 0) {
+        BOOST_THROW_EXCEPTION(runtime_error("Remove failed"));
+    }
+
+    auto db = make_shared<RandomDB>(sChain.get(), dirName, fileName, node_id(1), RANDOM_DB_SIZE,
+                                     LevelDBProfile::smallValueDefaults());
+
+    auto startTime = Time::getCurrentTimeMs();
+
+    for (uint64_t i = 1; i <= WRITES; i++) {
+        if (_scanDiskOnEachWrite) {
+            // emulate the old write path that walked the db directory twice per write
+            db->getActiveDBSize();
+            db->getActiveDBSize();
+        }
+        db->writeRandom(block_id(i), schain_index(1), bin_consensus_round(0), i);
+    }
+
+    auto elapsedMs = std::max(Time::getCurrentTimeMs() - startTime, (uint64_t) 1);
+
+    cerr << (_scanDiskOnEachWrite ? "Directory scan" : "Cached size") << " writes/sec:"
+         << WRITES * 1000 / elapsedMs << endl;
+
+    REQUIRE(db->readRandom(block_id(WRITES), schain_index(1), bin_consensus_round(0)) == WRITES);
+}
+
+TEST_CASE("Measure db write throughput", "[db-write-benchmark][.]") {
+    SECTION("Directory scan on each write")
+        test_db_write_throughput(true);
+    SECTION("Cached active db size")
+        test_db_write_throughput(false);
+}
+
+void test_db_key_encoding() {
+
+    DBKey key(block_id(12));
+    key.add(3).addTag(DBKey::BVB_VOTE).add(1);
+
+    REQUIRE(key.getSize() == 1 + 4 * DBKey::FIELD_SIZE);
+    REQUIRE(key.getBlockId() == 12);
+    REQUIRE(key.toLegacyString() == "1.0:12:3:bvb:1");
+
+    // a prefix covers whole fields only, so block 12 does not match block 123
+
+    DBKey otherBlock(block_id(123));
+    otherBlock.add(3);
+
+    REQUIRE(DBKey(block_id(12)).isPrefixOf(key.getData(), key.getSize()));
+    REQUIRE(!DBKey(block_id(12)).isPrefixOf(otherBlock.getData(), otherBlock.getSize()));
+
+    DBKey converted;
+
+    REQUIRE(DBKey::fromLegacyString("1.0:12:3:bvb:1", converted));
+    REQUIRE(string(converted.getData(), converted.getSize()) == string(key.getData(), key.getSize()));
+    REQUIRE(converted.getBlockId() == 12);
+
+    REQUIRE(DBKey::fromLegacyString("1.0:COUNTER:5", converted));
+    REQUIRE(converted.getBlockId() == 5);
+
+    REQUIRE(!DBKey::fromLegacyString("2.0:12", converted));
+}
+
+TEST_CASE("Encode binary db keys", "[db-key-encoding]") {
+    test_db_key_encoding();
+}
+
+void test_consensus_state_batch() {
+
+    auto sChain = make_shared<Schain>();
+    static string dirName = "/tmp";
+    static string fileName = "test_consensus_state_batch";
+
+    if (std::system(("rm -rf " + dirName + "/" + fileName).c_str()) != 0) {
+        BOOST_THROW_EXCEPTION(runtime_error("Remove failed"));
+    }
+
+    {
+        auto db = make_shared<ConsensusStateDB>(sChain.get(), dirName, fileName, node_id(1),
+                                                CONSENSUS_STATE_DB_SIZE, LevelDBProfile::smallValueDefaults());
+
+        db->startBatch();
+
+        db->writeCR(block_id(5), schain_index(2), bin_consensus_round(3));
+        db->writePr(block_id(5), schain_index(2), bin_consensus_round(3), bin_consensus_value(1));
+        db->writeBinValue(block_id(5), schain_index(2), bin_consensus_round(3), bin_consensus_value(1));
+
+        // pending writes are visible to the batching thread before they are written
+
+        REQUIRE(db->readCR(block_id(5), schain_index(2)) == 3);
+        REQUIRE(db->readPRs(block_id(5), schain_index(2))->size() == 1);
+
+        db->commitBatch();
+    }
+
+    auto db = make_shared<ConsensusStateDB>(sChain.get(), dirName, fileName, node_id(1),
+                                            CONSENSUS_STATE_DB_SIZE, LevelDBProfile::smallValueDefaults());
+
+    REQUIRE(db->readCR(block_id(5), schain_index(2)) == 3);
+    REQUIRE(db->readPR(block_id(5), schain_index(2), bin_consensus_round(3)) == 1);
+    REQUIRE(db->readBinValues(block_id(5), schain_index(2))->at(bin_consensus_round(3)).size() == 1);
+}
+
+TEST_CASE("Write consensus state in a batch", "[consensus-state-batch]") {
+    test_consensus_state_batch();
+}
+
+class TestSetDB : public CacheLevelDB {
+public:
+    TestSetDB(Schain *_sChain, string &_dirName, string &_prefix) : CacheLevelDB(_sChain, _dirName, _prefix,
+                                                                                 node_id(1), 10000000,
+                                                                                 LevelDBProfile::smallValueDefaults()) {}
+
+    using CacheLevelDB::writeStringToSet;
+    using CacheLevelDB::readCount;
+    using CacheLevelDB::keyExistsInSet;
+};
+
+void test_set_threshold_and_rebuild() {
+
+    auto sChain = make_shared<Schain>();
+    static string dirName = "/tmp";
+    static string fileName = "test_set_threshold_and_rebuild";
+
+    if (std::system(("rm -rf " + dirName + "/" + fileName).c_str()) != 0) {
+        BOOST_THROW_EXCEPTION(runtime_error("Remove failed"));
+    }
+
+    auto required = sChain->getRequiredSigners();
+
+    {
+        auto db = make_shared<TestSetDB>(sChain.get(), dirName, fileName);
+
+        for (uint64_t i = 1; i < required; i++) {
+            REQUIRE(db->writeStringToSet(to_string(i), block_id(7), schain_index(i)) == nullptr);
+        }
+
+        // duplicates are not counted
+        REQUIRE(db->writeStringToSet("1", block_id(7), schain_index(1)) == nullptr);
+        REQUIRE(db->readCount(block_id(7)) == required - 1);
+    }
+
+    // the set is rebuilt from the db after a restart
+
+    auto db = make_shared<TestSetDB>(sChain.get(), dirName, fileName);
+
+    REQUIRE(db->readCount(block_id(7)) == required - 1);
+    REQUIRE(db->keyExistsInSet(block_id(7), schain_index(1)));
+
+    auto enoughSet = db->writeStringToSet(to_string(required), block_id(7), schain_index(required));
+
+    REQUIRE(enoughSet != nullptr);
+    REQUIRE(enoughSet->size() == required);
+    REQUIRE(*enoughSet->at(schain_index(1)) == "1");
+}
+
+TEST_CASE("Accumulate threshold sets", "[db-set-threshold]") {
+    test_set_threshold_and_rebuild();
+}
+
+void test_block_proposal_cache() {
+
+    auto sChain = make_shared<Schain>();
+    static string dirName = "/tmp";
+    static string fileName = "test_block_proposal_cache";
+    boost::random::mt19937 gen;
+    auto cryptoManager = make_shared<CryptoManager>(*sChain);
+
+    boost::random::uniform_int_distribution<> ubyte(0, 255);
+
+    if (std::system(("rm -rf " + dirName + "/" + fileName).c_str()) != 0) {
+        BOOST_THROW_EXCEPTION(runtime_error("Remove failed"));
+    }
+
+    // two blocks per proposer are kept in memory
+    auto db = make_shared<BlockProposalDB>(sChain.get(), dirName, fileName, node_id(1), BLOCK_PROPOSAL_DB_SIZE,
+                                           LevelDBProfile::largeValueDefaults(), 2);
+
+    vector<ptr<BlockProposal>> proposals;
+
+    for (uint64_t i = 1; i <= 3; i++) {
+        auto proposal = make_shared<BlockProposal>(1, 1, block_id(i), schain_index(1),
+                                                   TransactionList::createRandomSample(5, gen, ubyte), u256(i),
+                                                   MODERN_TIME + i, 0, nullptr, cryptoManager);
+        db->addBlockProposal(proposal);
+        proposals.push_back(proposal);
+    }
+
+    REQUIRE(db->getBlockProposal(block_id(3), schain_index(1)) == proposals.at(2));
+    REQUIRE(db->getCacheHits() == 1);
+    REQUIRE(db->getBlockProposal(block_id(2), schain_index(1)) == proposals.at(1));
+    REQUIRE(db->getCacheHits() == 2);
+    REQUIRE(db->getCacheMisses() == 0);
+
+    // the oldest block left the cache, but is still in the db
+    REQUIRE(db->getSerializedProposalFromLevelDB(block_id(1), schain_index(1)) != nullptr);
+
+    // a block ahead of the cached window is a miss
+    REQUIRE(db->getBlockProposal(block_id(4), schain_index(1)) == nullptr);
+    REQUIRE(db->getCacheMisses() == 1);
+
+    // so is a proposer that did not propose
+    auto otherProposer = schain_index(sChain->getTotalSigners());
+    if (otherProposer > 1) {
+        REQUIRE(db->getBlockProposal(block_id(3), otherProposer) == nullptr);
+        REQUIRE(db->getCacheMisses() == 2);
+    }
+
+    REQUIRE(db->getCacheHits() == 2);
+
+    // a second proposal for a stored slot does not replace the first one
+    auto duplicate = make_shared<BlockProposal>(1, 1, block_id(3), schain_index(1),
+                                                TransactionList::createRandomSample(5, gen, ubyte), u256(7),
+                                                MODERN_TIME + 3, 0, nullptr, cryptoManager);
+    db->addBlockProposal(duplicate);
+
+    REQUIRE(db->getBlockProposal(block_id(3), schain_index(1)) == proposals.at(2));
+}
+
+TEST_CASE("Cache block proposals", "[block-proposal-cache]") {
+    test_block_proposal_cache();
+}
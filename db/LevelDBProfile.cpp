@@ -0,0 +1,72 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file LevelDBProfile.cpp
+    @author Stan Kladko
+    @date 2019
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/InvalidArgumentException.h"
+
+#include "LevelDBProfile.h"
+
+
+LevelDBProfile::LevelDBProfile(uint64_t _blockCacheSize, uint64_t _writeBufferSize, uint64_t _maxOpenFiles,
+                               bool _compression, uint64_t _filterBits, uint64_t _blockSize)
+        : blockCacheSize(_blockCacheSize), writeBufferSize(_writeBufferSize), maxOpenFiles(_maxOpenFiles),
+          compression(_compression), filterBits(_filterBits), blockSize(_blockSize) {
+    CHECK_ARGUMENT(_writeBufferSize > 0);
+    CHECK_ARGUMENT(_maxOpenFiles > 0);
+    CHECK_ARGUMENT(_blockSize > 0);
+}
+
+LevelDBProfile LevelDBProfile::largeValueDefaults() {
+    return LevelDBProfile(LARGE_VALUE_DB_CACHE_SIZE, LARGE_VALUE_DB_WRITE_BUFFER_SIZE, LARGE_VALUE_DB_MAX_OPEN_FILES,
+                          true, DB_FILTER_BITS, LARGE_VALUE_DB_BLOCK_SIZE);
+}
+
+LevelDBProfile LevelDBProfile::smallValueDefaults() {
+    return LevelDBProfile(SMALL_VALUE_DB_CACHE_SIZE, SMALL_VALUE_DB_WRITE_BUFFER_SIZE, SMALL_VALUE_DB_MAX_OPEN_FILES,
+                          false, DB_FILTER_BITS, SMALL_VALUE_DB_BLOCK_SIZE);
+}
+
+uint64_t LevelDBProfile::getBlockCacheSize() const {
+    return blockCacheSize;
+}
+
+uint64_t LevelDBProfile::getWriteBufferSize() const {
+    return writeBufferSize;
+}
+
+uint64_t LevelDBProfile::getMaxOpenFiles() const {
+    return maxOpenFiles;
+}
+
+bool LevelDBProfile::isCompression() const {
+    return compression;
+}
+
+uint64_t LevelDBProfile::getFilterBits() const {
+    return filterBits;
+}
+
+uint64_t LevelDBProfile::getBlockSize() const {
+    return blockSize;
+}
@@ -0,0 +1,70 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file LevelDBProfile.h
+    @author Stan Kladko
+    @date 2019
+*/
+
+#ifndef SKALED_LEVELDBPROFILE_H
+#define SKALED_LEVELDBPROFILE_H
+
+
+// LevelDB tuning of one consensus db, shared by all of its shards
+
+class LevelDBProfile {
+
+    uint64_t blockCacheSize;
+
+    uint64_t writeBufferSize;
+
+    uint64_t maxOpenFiles;
+
+    bool compression;
+
+    // bloom filter bits per key, 0 disables the filter
+    uint64_t filterBits;
+
+    uint64_t blockSize;
+
+public:
+
+    LevelDBProfile(uint64_t _blockCacheSize, uint64_t _writeBufferSize, uint64_t _maxOpenFiles, bool _compression,
+                   uint64_t _filterBits, uint64_t _blockSize);
+
+    // large append-only values such as committed blocks and proposals
+    static LevelDBProfile largeValueDefaults();
+
+    // small, frequently read and written entries such as consensus state and signature shares
+    static LevelDBProfile smallValueDefaults();
+
+    uint64_t getBlockCacheSize() const;
+
+    uint64_t getWriteBufferSize() const;
+
+    uint64_t getMaxOpenFiles() const;
+
+    bool isCompression() const;
+
+    uint64_t getFilterBits() const;
+
+    uint64_t getBlockSize() const;
+};
+
+
+#endif //SKALED_LEVELDBPROFILE_H
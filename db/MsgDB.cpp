@@ -27,6 +27,7 @@
 #include "crypto/SHAHash.h"
 #include "chains/Schain.h"
 #include "exceptions/InvalidStateException.h"
+#include "exceptions/Exception.h"
 #include "messages/NetworkMessage.h"
 
 #include "MsgDB.h"
@@ -34,59 +35,170 @@
 #include "CacheLevelDB.h"
 
 
-MsgDB::MsgDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize)
+MsgDB::MsgDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+             const LevelDBProfile &_profile)
         : CacheLevelDB(_sChain, _dirName, _prefix,
-                       _nodeId, _maxDBSize, false) {
+                       _nodeId, _maxDBSize, _profile, false), journalQueue(MSG_JOURNAL_QUEUE_SIZE) {
+
+    // keys are never read before writing, so the counter starts at the current time
+    // to stay unique across restarts
+    msgCounter = (uint64_t) chrono::duration_cast<chrono::microseconds>(
+            chrono::system_clock::now().time_since_epoch()).count();
+
+    journalThread = thread(&MsgDB::journalLoop, this);
+}
+
+MsgDB::~MsgDB() {
+    journalExitRequested = true;
+    journalCond.notify_all();
+    if (journalThread.joinable())
+        journalThread.join();
 }
 
+void MsgDB::enqueue(JournalEntry *_entry) {
+    CHECK_STATE(_entry);
+    CHECK_STATE(journalQueue.push(_entry));
+    // notify under the mutex so the push cannot land between the
+    // journal thread's emptiness check and its wait
+    lock_guard<mutex> lock(journalMutex);
+    journalCond.notify_one();
+}
 
 bool
 MsgDB::saveMsg(ptr<NetworkMessage> _msg) {
 
-    static atomic<uint64_t> msgCounter = 0;
+    try {
 
-    lock_guard<recursive_mutex> lock(m);
+        CHECK_ARGUMENT(_msg);
 
-    try {
+        JournalEntry entry;
+        entry.msg = _msg;
+        entry.hasWaiter = true;
 
+        enqueue(&entry);
 
-        CHECK_STATE(_msg);
+        unique_lock<mutex> lock(journalMutex);
+        writtenCond.wait(lock, [&entry] { return entry.written; });
 
+        CHECK_STATE2(!entry.failed, "Could not write message to journal");
 
-        auto s = _msg->serializeToString();
+        return true;
 
-        auto currentCounter = msgCounter++;
+    } catch (...) {
+        throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
+    }
 
-        auto key = createKey(_msg->getBlockID(), currentCounter);
+}
 
-        auto previous = readString(*key);
+void MsgDB::saveMsgAsync(ptr<NetworkMessage> _msg) {
 
-        if (previous == nullptr) {
-            writeString(*key, *s);
-            return true;
-        }
+    CHECK_ARGUMENT(_msg);
 
-        return (*previous == *s);
+    auto entry = new JournalEntry();
+    entry->msg = _msg;
+
+    enqueue(entry);
+}
+
+void MsgDB::flush() {
+
+    try {
+
+        // entries are written in queue order, so once the barrier is written so is everything before it
+        JournalEntry barrier;
+        barrier.hasWaiter = true;
+
+        enqueue(&barrier);
+
+        unique_lock<mutex> lock(journalMutex);
+        writtenCond.wait(lock, [&barrier] { return barrier.written; });
+
+        CHECK_STATE2(!barrier.failed, "Could not write messages to journal");
 
     } catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
     }
+}
+
+void MsgDB::journalLoop() {
 
+    vector<JournalEntry*> entries;
+
+    while (true) {
+
+        JournalEntry *entry = nullptr;
+
+        while (entries.size() < MAX_MSG_JOURNAL_BATCH && journalQueue.pop(entry)) {
+            entries.push_back(entry);
+        }
+
+        if (entries.empty()) {
+            // queue is drained, so it is safe to exit
+            if (journalExitRequested)
+                return;
+            unique_lock<mutex> lock(journalMutex);
+            journalCond.wait_for(lock, chrono::milliseconds(MSG_JOURNAL_WAIT_MS), [this] {
+                return journalExitRequested || !journalQueue.empty();
+            });
+            continue;
+        }
+
+        writeEntries(entries);
+
+        entries.clear();
+    }
 }
 
-ptr<vector<ptr<NetworkMessage>>> MsgDB::getMessages(block_id _blockID) {
+void MsgDB::writeEntries(vector<JournalEntry *> &_entries) {
 
+    bool failed = false;
 
-    auto result = make_shared<vector<ptr<NetworkMessage>>>();
+    try {
+        startBatch();
+        for (auto &&entry : _entries) {
+            if (entry->msg == nullptr)
+                continue;
+            auto key = createKey(entry->msg->getBlockID(), msgCounter++);
+            // keys are unique, so there is nothing to read before the write
+            writeString(key, *entry->msg->serializeToBinary(), true);
+        }
+        commitBatch();
+    } catch (exception &e) {
+        failed = true;
+        Exception::logNested(e);
+        abortBatch();
+    }
 
-    lock_guard<recursive_mutex> lock(m);
+    {
+        lock_guard<mutex> lock(journalMutex);
+        // a waiter also learns about failed writes of earlier async entries
+        failedSinceWaiter = failedSinceWaiter || failed;
+        bool hasWaiters = false;
+        for (auto &&entry : _entries) {
+            if (entry->hasWaiter) {
+                entry->failed = failedSinceWaiter;
+                entry->written = true;
+                hasWaiters = true;
+            } else {
+                delete entry;
+            }
+        }
+        if (hasWaiters)
+            failedSinceWaiter = false;
+    }
 
+    writtenCond.notify_all();
+}
 
+ptr<vector<ptr<NetworkMessage>>> MsgDB::getMessages(block_id _blockID) {
+
+
+    auto result = make_shared<vector<ptr<NetworkMessage>>>();
 
     try {
 
 
-        string prefix = getFormatVersion() + ":" + to_string(_blockID);
+        auto prefix = createKey(_blockID);
 
         auto messages = readPrefixRange(prefix);
 
@@ -106,10 +218,6 @@ ptr<vector<ptr<NetworkMessage>>> MsgDB::getMessages(block_id _blockID) {
 
 }
 
-const string MsgDB::getFormatVersion() {
-    return "1.0";
-}
-
 
 
 
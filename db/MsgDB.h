@@ -26,24 +26,67 @@
 #define SKALED_OUTGOING_MSG_DB_H
 
 
+#include <boost/lockfree/queue.hpp>
+
 #include "CacheLevelDB.h"
 
 class CryptoManager;
 class NetworkMessage;
 
+// append-only message journal. Messages are queued lock-free and written
+// by a journal thread, which writes everything it drained in one LevelDB batch
 class MsgDB : public CacheLevelDB {
 
-    recursive_mutex m;
+    class JournalEntry {
+    public:
+        // nullptr for a flush() barrier
+        ptr<NetworkMessage> msg;
+        // set for callers waiting on the entry, which then own it
+        bool hasWaiter = false;
+        bool written = false;
+        bool failed = false;
+    };
+
+    boost::lockfree::queue<JournalEntry*> journalQueue;
+
+    mutex journalMutex;
+    condition_variable journalCond;
+    condition_variable writtenCond;
+
+    atomic<bool> journalExitRequested = false;
+
+    // a write failed since the last waiter was released, guarded by journalMutex
+    bool failedSinceWaiter = false;
+
+    // only touched by the journal thread
+    uint64_t msgCounter;
+
+    thread journalThread;
+
+    void enqueue(JournalEntry* _entry);
+
+    void journalLoop();
+
+    void writeEntries(vector<JournalEntry*> &_entries);
 
 public:
 
-    MsgDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize);
+    MsgDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+          const LevelDBProfile &_profile);
 
+    ~MsgDB() override;
+
+    // returns once the message is on disk. Concurrent callers share one write
     bool saveMsg(ptr<NetworkMessage> _msg);
 
+    // queues the message for the journal thread and returns immediately
+    void saveMsgAsync(ptr<NetworkMessage> _msg);
+
+    // returns once every message queued by the calling thread is on disk
+    void flush();
+
     ptr<vector<ptr<NetworkMessage>>> getMessages(block_id _blockID);
 
-    const string getFormatVersion() override ;
 };
 
 
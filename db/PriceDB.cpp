@@ -31,16 +31,13 @@
 
 #include "chains/Schain.h"
 
-PriceDB::PriceDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize)
+PriceDB::PriceDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                 const LevelDBProfile &_profile)
         : CacheLevelDB(_sChain, _dirName, _prefix,
                        _nodeId,
-                       _maxDBSize, false) {}
+                       _maxDBSize, _profile, false) {}
 
 
-const string PriceDB::getFormatVersion() {
-    return "1.0";
-}
-
 
 u256 PriceDB::readPrice(block_id _blockID) {
 
@@ -56,7 +53,7 @@ u256 PriceDB::readPrice(block_id _blockID) {
 
         auto key = createKey(_blockID);
 
-        auto price = readString(*key);
+        auto price = readString(key);
 
         if (price == nullptr) {
             BOOST_THROW_EXCEPTION(InvalidArgumentException("Price for block " +
@@ -81,7 +78,7 @@ void PriceDB::savePrice(u256 _price, block_id _blockID) {
 
         auto value = _price.str();
 
-        writeString(*key, value);
+        writeString(key, value);
     } catch (ExitRequestedException &) { throw; } catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
     }
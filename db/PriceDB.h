@@ -33,9 +33,8 @@ class PriceDB : public CacheLevelDB {
 
 public:
 
-    const string getFormatVersion() override ;
-
-    PriceDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize);
+    PriceDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+            const LevelDBProfile &_profile);
 
     u256 readPrice(block_id _blockID);
 
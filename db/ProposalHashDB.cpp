@@ -33,9 +33,10 @@
 #include "CacheLevelDB.h"
 
 
-ProposalHashDB::ProposalHashDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize)
+ProposalHashDB::ProposalHashDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                               const LevelDBProfile &_profile)
         : CacheLevelDB(_sChain, _dirName, _prefix,
-                       _nodeId, _maxDBSize, false) {
+                       _nodeId, _maxDBSize, _profile, false) {
 }
 
 
@@ -49,10 +50,10 @@ ProposalHashDB::checkAndSaveHash(block_id _proposalBlockID, schain_index _propos
 
         auto key = createKey(_proposalBlockID, _proposerIndex);
 
-        auto previous = readString(*key);
+        auto previous = readString(key);
 
         if (previous == nullptr) {
-            writeString(*key, *_proposalHash);
+            writeString(key, *_proposalHash);
             return true;
         }
 
@@ -74,7 +75,7 @@ ProposalHashDB::haveProposal(block_id _proposalBlockID, schain_index _proposerIn
 
         auto key = createKey(_proposalBlockID, _proposerIndex);
 
-        auto previous = readString(*key);
+        auto previous = readString(key);
 
         return (previous != nullptr);
 
@@ -84,10 +85,6 @@ ProposalHashDB::haveProposal(block_id _proposalBlockID, schain_index _proposerIn
 
 }
 
-const string ProposalHashDB::getFormatVersion() {
-    return "1.0";
-}
-
 
 
 
@@ -39,13 +39,13 @@ class ProposalHashDB : public CacheLevelDB {
 
 public:
 
-    ProposalHashDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize);
+    ProposalHashDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                   const LevelDBProfile &_profile);
 
     bool checkAndSaveHash(block_id _proposalBlockID, schain_index _proposerIndex, ptr<string> _proposalHash);
 
     bool haveProposal(block_id _proposalBlockID, schain_index _proposerIndex);
 
-    const string getFormatVersion() override ;
 };
 
 
@@ -33,9 +33,10 @@
 #include "CacheLevelDB.h"
 
 
-ProposalVectorDB::ProposalVectorDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize)
+ProposalVectorDB::ProposalVectorDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                                   const LevelDBProfile &_profile)
         : CacheLevelDB(_sChain, _dirName, _prefix,
-                       _nodeId, _maxDBSize, false) {
+                       _nodeId, _maxDBSize, _profile, false) {
 }
 
 
@@ -53,10 +54,10 @@ ProposalVectorDB::saveVector(block_id _proposalBlockID, ptr<BooleanProposalVecto
 
         auto key = createKey(_proposalBlockID);
 
-        auto previous = readString(*key);
+        auto previous = readString(key);
 
         if (previous == nullptr) {
-            writeString(*key, *proposalString);
+            writeString(key, *proposalString);
             return true;
         }
 
@@ -78,7 +79,7 @@ ProposalVectorDB::getVector(block_id _blockID) {
 
         auto key = createKey(_blockID);
 
-        auto value = readString(*key);
+        auto value = readString(key);
 
         if (value == nullptr) {
             return nullptr;
@@ -90,10 +91,6 @@ ProposalVectorDB::getVector(block_id _blockID) {
 
 }
 
-const string ProposalVectorDB::getFormatVersion() {
-    return "1.0";
-}
-
 
 
 
@@ -36,13 +36,13 @@ class ProposalVectorDB : public CacheLevelDB {
 
 public:
 
-    ProposalVectorDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize);
+    ProposalVectorDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                     const LevelDBProfile &_profile);
 
     bool saveVector(block_id _proposalBlockID, ptr<BooleanProposalVector> _proposalVector);
 
     ptr<BooleanProposalVector> getVector(block_id _blockID);
 
-    const string getFormatVersion() override ;
 };
 
 
@@ -29,20 +29,17 @@
 #include "CacheLevelDB.h"
 
 
-RandomDB::RandomDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize) :
-        CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, false) {}
+RandomDB::RandomDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+                   const LevelDBProfile &_profile) :
+        CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, _profile, false) {}
 
 
-const string RandomDB::getFormatVersion() {
-    return "1.0";
-}
-
 
 uint64_t
 RandomDB::readRandom(const block_id &_blockId, const schain_index &_proposerIndex, const bin_consensus_round &_round) {
 
     auto key = createKey(_blockId, _proposerIndex, _round);
-    auto value = readString(*key);
+    auto value = readString(key);
     return stoul(*value);
 
 }
@@ -55,7 +52,7 @@ RandomDB::writeRandom(const block_id &_blockId, const schain_index &_proposerInd
 
     auto key = createKey(_blockId, _proposerIndex, _round);
 
-    writeString(*key, to_string(_random));
+    writeString(key, to_string(_random));
 
 }
 
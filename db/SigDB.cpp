@@ -32,21 +32,18 @@
 #include "SigDB.h"
 
 
-SigDB::SigDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize) :
-        CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, false) {}
+SigDB::SigDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+             const LevelDBProfile &_profile) :
+        CacheLevelDB(_sChain, _dirName, _prefix, _nodeId, _maxDBSize, _profile, false) {}
 
 
-const string SigDB::getFormatVersion() {
-    return "1.0";
-}
-
 
 
 
 void SigDB::addSignature(block_id _blockId, ptr<ThresholdSignature> _sig) {
     auto key = createKey(_blockId);
-    if (readString(*key) == nullptr)
-        writeString(*key, *_sig->toString());
+    if (readString(key) == nullptr)
+        writeString(key, *_sig->toString());
 }
 
 
@@ -36,11 +36,10 @@ class SigDB : public CacheLevelDB {
 
     node_id nodeId;
 
-    const string getFormatVersion();
-
 public:
 
-    SigDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize);
+    SigDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize,
+          const LevelDBProfile &_profile);
 
     void addSignature(block_id _blockId, ptr<ThresholdSignature> _sig);
 
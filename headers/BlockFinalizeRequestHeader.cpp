@@ -46,9 +46,10 @@ using namespace std;
 
 
 BlockFinalizeRequestHeader::BlockFinalizeRequestHeader(Schain &_sChain, block_id _blockID, schain_index _proposerIndex,
-                                                           fragment_index _fragmentIndex) :
+                                                           fragment_index _fragmentIndex, bool _erasureCoded) :
         AbstractBlockRequestHeader(_sChain.getNodeCount(), _sChain.getSchainID(), _blockID,
-                Header::BLOCK_FINALIZE_REQ, _proposerIndex), fragmentIndex(_fragmentIndex) {
+                Header::BLOCK_FINALIZE_REQ, _proposerIndex), fragmentIndex(_fragmentIndex),
+        erasureCoded(_erasureCoded) {
 
     CHECK_ARGUMENT(_fragmentIndex > 0);
 
@@ -63,6 +64,9 @@ void BlockFinalizeRequestHeader::addFields(nlohmann::basic_json<> &jsonRequest)
 
     jsonRequest["fragmentIndex"] = (uint64_t ) fragmentIndex;
 
+    if (erasureCoded)
+        jsonRequest["erasureCoded"] = true;
+
 }
 
 
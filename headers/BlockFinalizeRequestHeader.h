@@ -32,11 +32,13 @@ class BlockFinalizeRequestHeader : public AbstractBlockRequestHeader{
 
    fragment_index fragmentIndex;
 
+   bool erasureCoded;
+
 
 public:
 
     BlockFinalizeRequestHeader(Schain &_sChain, block_id _blockID, schain_index _proposerIndex,
-            fragment_index _fragmentIndex);
+            fragment_index _fragmentIndex, bool _erasureCoded = false);
 
 
 
@@ -48,6 +48,24 @@ void BlockFinalizeResponseHeader::addFields(nlohmann::json &_j) {
     _j["blockHash"] = *blockHash;
     _j["fragmentSize"] = (uint64_t) fragmentSize;
     _j["blockSize"] = (uint64_t) blockSize;
+
+    if (dataFragments > 0) {
+        _j["dataFragments"] = dataFragments;
+        auto hashes = nlohmann::json::array();
+        for (auto &&hash : *fragmentHashes) {
+            hashes.push_back(*hash);
+        }
+        _j["fragmentHashes"] = hashes;
+    }
+}
+
+void BlockFinalizeResponseHeader::setErasureParams(uint64_t _dataFragments,
+                                                   ptr<vector<ptr<string>>> _fragmentHashes) {
+    CHECK_ARGUMENT(_dataFragments > 0)
+    CHECK_ARGUMENT(_fragmentHashes != nullptr)
+
+    dataFragments = _dataFragments;
+    fragmentHashes = _fragmentHashes;
 }
 
 void BlockFinalizeResponseHeader::setFragmentParams(uint64_t _fragmentSize, uint64_t _blockSize, ptr<string> _hash) {
@@ -32,11 +32,16 @@ class BlockFinalizeResponseHeader : public Header {
     uint64_t  blockSize = 0;
     ptr<string> blockHash = nullptr;
 
+    uint64_t dataFragments = 0;
+    ptr<vector<ptr<string>>> fragmentHashes = nullptr;
+
 
 public:
 
     void setFragmentParams(uint64_t _fragmentSize, uint64_t _blockSize, ptr<string> _hash);
 
+    void setErasureParams(uint64_t _dataFragments, ptr<vector<ptr<string>>> _fragmentHashes);
+
 
 
     BlockFinalizeResponseHeader();
@@ -57,6 +57,13 @@ CatchupRequestHeader::CatchupRequestHeader(Schain &_sChain, schain_index _dstInd
 
 }
 
+CatchupRequestHeader::CatchupRequestHeader(Schain &_sChain, schain_index _dstIndex, block_id _blockID,
+                                           block_id _toBlockID) : CatchupRequestHeader(_sChain, _dstIndex) {
+    CHECK_ARGUMENT(_toBlockID == 0 || _toBlockID > _blockID);
+    this->blockID = _blockID;
+    this->toBlockID = _toBlockID;
+}
+
 void CatchupRequestHeader::addFields(nlohmann::json& _j) {
 
     Header::addFields(_j);
@@ -64,6 +71,9 @@ void CatchupRequestHeader::addFields(nlohmann::json& _j) {
     _j["schainID"] = (uint64_t ) schainID;
     _j["blockID"] = (uint64_t ) blockID;
 
+    if (toBlockID > 0)
+        _j["toBlockID"] = (uint64_t ) toBlockID;
+
 }
 
 
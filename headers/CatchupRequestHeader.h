@@ -39,6 +39,9 @@ class CatchupRequestHeader : public Header{
     schain_id schainID;
     block_id blockID;
 
+    // zero means up to the last committed block of the server
+    block_id toBlockID = 0;
+
 public:
 
 
@@ -46,6 +49,9 @@ public:
 
     CatchupRequestHeader(Schain &_sChain, schain_index _dstIndex);
 
+    // requests blocks (_blockID, _toBlockID], a zero _toBlockID leaves the range open
+    CatchupRequestHeader(Schain &_sChain, schain_index _dstIndex, block_id _blockID, block_id _toBlockID);
+
 
     void addFields(nlohmann::basic_json<> &j) override;
 
@@ -54,6 +54,10 @@ void CatchupResponseHeader::addFields(nlohmann::json &_j) {
 
     _j["count"] = blockCount;
 
+    _j["more"] = (uint64_t) more;
+
+    _j["lastBlockID"] = (uint64_t) lastBlockID;
+
     if (blockSizes != nullptr)
         _j["sizes"] = *blockSizes;
 
@@ -68,5 +72,17 @@ void CatchupResponseHeader::setBlockCount(uint64_t _blockCount) {
     CatchupResponseHeader::blockCount = _blockCount;
 }
 
+bool CatchupResponseHeader::hasMore() const {
+    return more;
+}
+
+void CatchupResponseHeader::setMore(bool _more) {
+    more = _more;
+}
+
+void CatchupResponseHeader::setLastBlockID(block_id _lastBlockID) {
+    lastBlockID = _lastBlockID;
+}
+
 
 
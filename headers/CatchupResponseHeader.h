@@ -44,10 +44,22 @@ public:
 
     void setBlockCount(uint64_t blockCount);
 
+    bool hasMore() const;
+
+    // set when the response was cut at the size limit and more committed blocks follow
+    void setMore(bool _more);
+
+    // last committed block of the server, lets the client split the rest across peers
+    void setLastBlockID(block_id _lastBlockID);
+
 
 private:
     uint64_t blockCount = 0;
 
+    bool more = false;
+
+    block_id lastBlockID = 0;
+
     ptr<list<uint64_t>> blockSizes = nullptr;
 
 public:
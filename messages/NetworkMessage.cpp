@@ -43,6 +43,7 @@
 #include "protocols/binconsensus/BVBroadcastMessage.h"
 #include "protocols/binconsensus/AUXBroadcastMessage.h"
 #include "protocols/blockconsensus/BlockSignBroadcastMessage.h"
+#include "NetworkMessageFields.h"
 #include "NetworkMessage.h"
 
 
@@ -127,46 +128,57 @@ void NetworkMessage::addFields(nlohmann::basic_json<> &j) {
 
 
 
-ptr<NetworkMessage> NetworkMessage::parseMessage(ptr<string> _header, Schain *_sChain) {
+ptr<NetworkMessageFields> NetworkMessage::getFields() const {
 
-    uint64_t sChainID;
-    uint64_t blockID;
-    uint64_t blockProposerIndex;
-    ptr<string> type;
-    uint64_t msgID;
-    uint64_t srcNodeID;
-    uint64_t srcSchainIndex;
-    uint64_t round;
-    uint8_t value;
-    ptr<string> sigShare;
+    auto fields = make_shared<NetworkMessageFields>();
 
-    CHECK_ARGUMENT(_header);
-    CHECK_ARGUMENT(_sChain);
+    fields->schainID = (uint64_t) schainID;
+    fields->blockID = (uint64_t) blockID;
+    fields->blockProposerIndex = (uint64_t) getBlockProposerIndex();
+    fields->msgType = msgType;
+    fields->msgID = (uint64_t) msgID;
+    fields->srcNodeID = (uint64_t) srcNodeID;
+    fields->srcSchainIndex = (uint64_t) srcSchainIndex;
+    fields->round = (uint64_t) r;
+    fields->value = (uint8_t) value;
+    fields->sigShare = sigShareString;
 
-    try {
+    return fields;
+}
 
-        auto js = nlohmann::json::parse(*_header);
+ptr<string> NetworkMessage::serializeToBinary() const {
+    CHECK_STATE(complete);
+    return getFields()->serializeToBinary();
+}
 
+ptr<NetworkMessage> NetworkMessage::parseMessage(ptr<string> _header, Schain *_sChain) {
+    CHECK_ARGUMENT(_header);
+    return parseMessage(_header->data(), _header->size(), _sChain);
+}
 
-        sChainID = getUint64(js, "si");
-        blockID = getUint64(js, "bi");
-        blockProposerIndex = getUint64(js, "bpi");
-        type = getString(js, "type");
-        msgID = getUint64(js, "mi");
-        srcNodeID = getUint64(js, "sni");
-        srcSchainIndex = getUint64(js, "ssi");
-        round = getUint64(js, "r");
-        value = getUint64(js, "v");
+ptr<NetworkMessage> NetworkMessage::parseMessage(const char *_data, uint64_t _len, Schain *_sChain) {
 
-        if (js.find("sss") != js.end()) {
-            sigShare = getString(js, "sss");
-        }
+    ptr<NetworkMessageFields> fields;
 
+    CHECK_ARGUMENT(_data);
+    CHECK_ARGUMENT(_sChain);
 
+    try {
+        fields = NetworkMessageFields::parse(_data, _len);
     } catch (ExitRequestedException &) { throw; } catch (...) {
         throw_with_nested(InvalidStateException("Could not parse message", __CLASS_NAME__));
     }
 
+    auto sChainID = fields->schainID;
+    auto blockID = fields->blockID;
+    auto blockProposerIndex = fields->blockProposerIndex;
+    auto msgID = fields->msgID;
+    auto srcNodeID = fields->srcNodeID;
+    auto srcSchainIndex = fields->srcSchainIndex;
+    auto round = fields->round;
+    auto value = fields->value;
+    auto sigShare = fields->sigShare;
+
     try {
 
         if (_sChain->getSchainID() != sChainID) {
@@ -176,14 +188,14 @@ ptr<NetworkMessage> NetworkMessage::parseMessage(ptr<string> _header, Schain *_s
 
         ptr<NetworkMessage> mptr;
 
-        if (*type == BasicHeader::BV_BROADCAST) {
+        if (fields->msgType == MSG_BVB_BROADCAST) {
             mptr = make_shared<BVBroadcastMessage>(node_id(srcNodeID),
                                                    block_id(blockID), schain_index(blockProposerIndex),
                                                    bin_consensus_round(round),
                                                    bin_consensus_value(value), schain_id(sChainID), msg_id(msgID),
                                                    srcSchainIndex,
                                                    _sChain);
-        } else if (*type == BasicHeader::AUX_BROADCAST) {
+        } else if (fields->msgType == MSG_AUX_BROADCAST) {
             mptr = make_shared<AUXBroadcastMessage>(node_id(srcNodeID),
                                                     block_id(blockID), schain_index(blockProposerIndex),
                                                     bin_consensus_round(round),
@@ -191,7 +203,7 @@ ptr<NetworkMessage> NetworkMessage::parseMessage(ptr<string> _header, Schain *_s
                                                     sigShare,
                                                     srcSchainIndex,
                                                     _sChain);
-        } else if (*type == BasicHeader::BLOCK_SIG_BROADCAST) {
+        } else if (fields->msgType == MSG_BLOCK_SIGN_BROADCAST) {
             mptr = make_shared<BlockSignBroadcastMessage>(node_id(srcNodeID),
                                                           block_id(blockID), schain_index(blockProposerIndex),
                                                           schain_id(sChainID), msg_id(msgID),
@@ -41,8 +41,10 @@ class ConsensusBLSSigShare;
 class Node;
 class ThresholdSigShare;
 class CryptoManager;
+class NetworkMessageFields;
 
 static constexpr uint64_t MAX_CONSENSUS_MESSAGE_LEN = 1024;
+static constexpr uint64_t MAX_CONSENSUS_FRAME_LEN = 64 * 1024;
 
 #include "headers/BasicHeader.h"
 
@@ -93,8 +95,15 @@ public:
 
     ptr<ThresholdSigShare> getSigShare() const;
 
+    ptr<NetworkMessageFields> getFields() const;
+
+    ptr<string> serializeToBinary() const;
+
+    // accepts both the JSON and the binary encoding
     static ptr<NetworkMessage> parseMessage(ptr<string> _header, Schain* _sChain);
 
+    static ptr<NetworkMessage> parseMessage(const char *_data, uint64_t _len, Schain* _sChain);
+
     static const char* getTypeString(MsgType _type );
 
     const schain_index &getSrcSchainIndex() const;
@@ -0,0 +1,269 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file NetworkMessageFields.cpp
+    @author Stan Kladko
+    @date 2019
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "thirdparty/json.hpp"
+#include "exceptions/InvalidStateException.h"
+#include "exceptions/InvalidMessageFormatException.h"
+#include "headers/BasicHeader.h"
+#include "NetworkMessage.h"
+
+#include "NetworkMessageFields.h"
+
+
+void NetworkMessageFields::writeVarint(string &_out, uint64_t _value) {
+    while (_value >= 0x80) {
+        _out.push_back((char) ((_value & 0x7F) | 0x80));
+        _value >>= 7;
+    }
+    _out.push_back((char) _value);
+}
+
+uint64_t NetworkMessageFields::readVarint(const char *_in, uint64_t _len, uint64_t &_pos) {
+    uint64_t result = 0;
+
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        if (_pos >= _len) {
+            BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Truncated varint", __CLASS_NAME__));
+        }
+        auto b = (uint8_t) _in[_pos++];
+        result |= ((uint64_t) (b & 0x7F)) << shift;
+        if ((b & 0x80) == 0)
+            return result;
+    }
+
+    BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Varint too long", __CLASS_NAME__));
+}
+
+ptr<string> NetworkMessageFields::serializeToBinary() const {
+
+    auto s = make_shared<string>();
+    s->reserve(64 + (sigShare ? sigShare->size() : 0));
+
+    s->push_back((char) BINARY_NETWORK_MESSAGE_MAGIC);
+    s->push_back((char) BINARY_NETWORK_MESSAGE_VERSION);
+    s->push_back((char) msgType);
+
+    writeVarint(*s, schainID);
+    writeVarint(*s, blockID);
+    writeVarint(*s, blockProposerIndex);
+    writeVarint(*s, msgID);
+    writeVarint(*s, srcNodeID);
+    writeVarint(*s, srcSchainIndex);
+    writeVarint(*s, round);
+
+    s->push_back((char) value);
+
+    if (sigShare != nullptr) {
+        writeVarint(*s, sigShare->size() + 1);
+        s->append(*sigShare);
+    } else {
+        writeVarint(*s, 0);
+    }
+
+    return s;
+}
+
+bool NetworkMessageFields::isBinary(const char *_in, uint64_t _len) {
+    return _len > 0 && (uint8_t) _in[0] == BINARY_NETWORK_MESSAGE_MAGIC;
+}
+
+bool NetworkMessageFields::isBinary(const string &_in) {
+    return isBinary(_in.data(), _in.size());
+}
+
+ptr<NetworkMessageFields> NetworkMessageFields::parse(const char *_in, uint64_t _len) {
+    CHECK_ARGUMENT(_in);
+    if (isBinary(_in, _len))
+        return parseBinary(_in, _len);
+    return parseJSON(_in, _len);
+}
+
+ptr<NetworkMessageFields> NetworkMessageFields::parse(const string &_in) {
+    return parse(_in.data(), _in.size());
+}
+
+MsgType NetworkMessageFields::msgTypeFromString(const string &_type) {
+    if (_type == BasicHeader::BV_BROADCAST) {
+        return MSG_BVB_BROADCAST;
+    } else if (_type == BasicHeader::AUX_BROADCAST) {
+        return MSG_AUX_BROADCAST;
+    } else if (_type == BasicHeader::BLOCK_SIG_BROADCAST) {
+        return MSG_BLOCK_SIGN_BROADCAST;
+    }
+    BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Unknown message type:" + _type, __CLASS_NAME__));
+}
+
+ptr<NetworkMessageFields> NetworkMessageFields::parseJSON(const char *_in, uint64_t _len) {
+
+    auto fields = make_shared<NetworkMessageFields>();
+
+    auto js = nlohmann::json::parse(_in, _in + _len);
+
+    fields->schainID = BasicHeader::getUint64(js, "si");
+    fields->blockID = BasicHeader::getUint64(js, "bi");
+    fields->blockProposerIndex = BasicHeader::getUint64(js, "bpi");
+    fields->msgType = msgTypeFromString(*BasicHeader::getString(js, "type"));
+    fields->msgID = BasicHeader::getUint64(js, "mi");
+    fields->srcNodeID = BasicHeader::getUint64(js, "sni");
+    fields->srcSchainIndex = BasicHeader::getUint64(js, "ssi");
+    fields->round = BasicHeader::getUint64(js, "r");
+    fields->value = BasicHeader::getUint64(js, "v");
+
+    if (js.find("sss") != js.end()) {
+        fields->sigShare = BasicHeader::getString(js, "sss");
+    }
+
+    return fields;
+}
+
+ptr<NetworkMessageFields> NetworkMessageFields::parseBinary(const char *_in, uint64_t _len) {
+
+    if (_len < 3) {
+        BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Binary message too short", __CLASS_NAME__));
+    }
+
+    if ((uint8_t) _in[1] != BINARY_NETWORK_MESSAGE_VERSION) {
+        BOOST_THROW_EXCEPTION(InvalidMessageFormatException(
+                                      "Unknown binary message version:" + to_string((uint8_t) _in[1]),
+                                      __CLASS_NAME__));
+    }
+
+    auto fields = make_shared<NetworkMessageFields>();
+
+    auto type = (uint8_t) _in[2];
+
+    if (type != MSG_BVB_BROADCAST && type != MSG_AUX_BROADCAST && type != MSG_BLOCK_SIGN_BROADCAST) {
+        BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Unknown message type:" + to_string(type),
+                                                            __CLASS_NAME__));
+    }
+
+    fields->msgType = (MsgType) type;
+
+    uint64_t pos = 3;
+
+    fields->schainID = readVarint(_in, _len, pos);
+    fields->blockID = readVarint(_in, _len, pos);
+    fields->blockProposerIndex = readVarint(_in, _len, pos);
+    fields->msgID = readVarint(_in, _len, pos);
+    fields->srcNodeID = readVarint(_in, _len, pos);
+    fields->srcSchainIndex = readVarint(_in, _len, pos);
+    fields->round = readVarint(_in, _len, pos);
+
+    if (pos >= _len) {
+        BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Truncated binary message", __CLASS_NAME__));
+    }
+
+    fields->value = (uint8_t) _in[pos++];
+
+    // zero means no sig share, otherwise the sig share length plus one
+    auto sigShareLen = readVarint(_in, _len, pos);
+
+    if (sigShareLen > 0) {
+        sigShareLen--;
+        if (sigShareLen > _len - pos) {
+            BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Truncated sig share", __CLASS_NAME__));
+        }
+        fields->sigShare = make_shared<string>(_in + pos, sigShareLen);
+        pos += sigShareLen;
+    }
+
+    if (pos != _len) {
+        BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Trailing bytes in binary message",
+                                                            __CLASS_NAME__));
+    }
+
+    return fields;
+}
+
+bool NetworkMessageFields::isBatch(const char *_in, uint64_t _len) {
+    return _len > 0 && (uint8_t) _in[0] == NETWORK_MESSAGE_BATCH_MAGIC;
+}
+
+ptr<string> NetworkMessageFields::packBatch(const vector<ptr<string>> &_messages) {
+
+    uint64_t totalSize = 16;
+
+    for (auto &&message : _messages) {
+        CHECK_ARGUMENT(message);
+        totalSize += message->size() + 10;
+    }
+
+    auto s = make_shared<string>();
+    s->reserve(totalSize);
+
+    s->push_back((char) NETWORK_MESSAGE_BATCH_MAGIC);
+    s->push_back((char) BINARY_NETWORK_MESSAGE_VERSION);
+
+    writeVarint(*s, _messages.size());
+
+    for (auto &&message : _messages) {
+        writeVarint(*s, message->size());
+        s->append(*message);
+    }
+
+    return s;
+}
+
+ptr<vector<pair<const char *, uint64_t>>> NetworkMessageFields::unpackBatch(const char *_in, uint64_t _len) {
+
+    CHECK_ARGUMENT(_in);
+
+    if (!isBatch(_in, _len) || _len < 3) {
+        BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Not a message batch", __CLASS_NAME__));
+    }
+
+    if ((uint8_t) _in[1] != BINARY_NETWORK_MESSAGE_VERSION) {
+        BOOST_THROW_EXCEPTION(InvalidMessageFormatException(
+                                      "Unknown message batch version:" + to_string((uint8_t) _in[1]),
+                                      __CLASS_NAME__));
+    }
+
+    uint64_t pos = 2;
+
+    auto count = readVarint(_in, _len, pos);
+
+    // every message takes at least two bytes
+    if (count > (_len - pos) / 2) {
+        BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Message batch count too large", __CLASS_NAME__));
+    }
+
+    auto result = make_shared<vector<pair<const char *, uint64_t>>>();
+    result->reserve(count);
+
+    for (uint64_t i = 0; i < count; i++) {
+        auto messageLen = readVarint(_in, _len, pos);
+        if (messageLen == 0 || messageLen > _len - pos) {
+            BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Truncated message in batch", __CLASS_NAME__));
+        }
+        result->emplace_back(_in + pos, messageLen);
+        pos += messageLen;
+    }
+
+    if (pos != _len) {
+        BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Trailing bytes in message batch", __CLASS_NAME__));
+    }
+
+    return result;
+}
@@ -0,0 +1,81 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file NetworkMessageFields.h
+    @author Stan Kladko
+    @date 2019
+*/
+
+#pragma once
+
+#include "Message.h"
+
+// wire fields of a consensus network message. JSON is the legacy encoding,
+// produced by NetworkMessage::serializeToString();
+// the binary encoding is a fixed header followed by varints and the raw sig share.
+// parse() detects the encoding, so nodes of mixed versions can talk to each other
+
+static constexpr uint8_t BINARY_NETWORK_MESSAGE_MAGIC = 0xB5;
+static constexpr uint8_t BINARY_NETWORK_MESSAGE_VERSION = 1;
+static constexpr uint8_t NETWORK_MESSAGE_BATCH_MAGIC = 0xB6;
+
+class NetworkMessageFields {
+
+    static void writeVarint(string &_out, uint64_t _value);
+
+    static uint64_t readVarint(const char *_in, uint64_t _len, uint64_t &_pos);
+
+    static ptr<NetworkMessageFields> parseJSON(const char *_in, uint64_t _len);
+
+    static ptr<NetworkMessageFields> parseBinary(const char *_in, uint64_t _len);
+
+public:
+
+    uint64_t schainID = 0;
+    uint64_t blockID = 0;
+    uint64_t blockProposerIndex = 0;
+    MsgType msgType = MSG_BVB_BROADCAST;
+    uint64_t msgID = 0;
+    uint64_t srcNodeID = 0;
+    uint64_t srcSchainIndex = 0;
+    uint64_t round = 0;
+    uint8_t value = 0;
+    ptr<string> sigShare;
+
+    ptr<string> serializeToBinary() const;
+
+    static bool isBinary(const char *_in, uint64_t _len);
+
+    static bool isBinary(const string &_in);
+
+    // parses in place, so _in can point straight into a receive buffer
+    static ptr<NetworkMessageFields> parse(const char *_in, uint64_t _len);
+
+    static ptr<NetworkMessageFields> parse(const string &_in);
+
+    static MsgType msgTypeFromString(const string &_type);
+
+    // a batch frame is a magic byte, a version byte, the message count and
+    // then every message as a varint length followed by the message bytes
+    static bool isBatch(const char *_in, uint64_t _len);
+
+    static ptr<string> packBatch(const vector<ptr<string>> &_messages);
+
+    // the returned pointers point into _in
+    static ptr<vector<pair<const char *, uint64_t>>> unpackBatch(const char *_in, uint64_t _len);
+};
@@ -101,6 +101,7 @@ void MonitoringAgent::monitoringLoop(MonitoringAgent *agent) {
 
             try {
                 agent->monitor();
+                agent->getSchain()->getNode()->refreshLevelDBSizes();
             } catch (ExitRequestedException &) {
                 return;
             } catch (exception &e) {
@@ -0,0 +1,70 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file BroadcastQuorum.cpp
+    @author Stan Kladko
+    @date 2019
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/Exception.h"
+
+#include "BroadcastQuorum.h"
+
+
+BroadcastQuorum::BroadcastQuorum(uint64_t _nodeCount, vector<function<void()>> _callbacks)
+        : required(requiredPeers(_nodeCount)), callbacks(move(_callbacks)) {
+    if (required == 0) {
+        for (auto &&callback : callbacks) {
+            callback();
+        }
+    }
+}
+
+uint64_t BroadcastQuorum::requiredPeers(uint64_t _nodeCount) {
+    CHECK_ARGUMENT(_nodeCount > 0);
+    // smallest count for which 3 * (count + 1) >= 2 * nodeCount
+    uint64_t count = 0;
+    while (3 * (count + 1) < _nodeCount * 2) {
+        count++;
+    }
+    return count;
+}
+
+void BroadcastQuorum::peerSent() {
+    // exactly one thread sees the count hit the quorum
+    if (++sentCount != required)
+        return;
+
+    for (auto &&callback : callbacks) {
+        try {
+            callback();
+        } catch (exception &e) {
+            Exception::logNested(e);
+        }
+    }
+}
+
+bool BroadcastQuorum::isReached() const {
+    return sentCount >= required;
+}
+
+uint64_t BroadcastQuorum::getSentCount() const {
+    return sentCount;
+}
@@ -0,0 +1,48 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file BroadcastQuorum.h
+    @author Stan Kladko
+    @date 2019
+*/
+
+#pragma once
+
+// counts the peers a broadcast has been sent to, and runs the callbacks
+// once the broadcast reached 2/3 of the chain
+class BroadcastQuorum {
+
+    uint64_t required;
+
+    atomic<uint64_t> sentCount = 0;
+
+    vector<function<void()>> callbacks;
+
+public:
+
+    BroadcastQuorum(uint64_t _nodeCount, vector<function<void()>> _callbacks);
+
+    void peerSent();
+
+    bool isReached() const;
+
+    uint64_t getSentCount() const;
+
+    // number of peers that need to get a message, not counting the sender itself
+    static uint64_t requiredPeers(uint64_t _nodeCount);
+};
@@ -36,6 +36,8 @@
 #include "exceptions/ConnectionRefusedException.h"
 #include "ClientSocket.h"
 
+#include <netinet/tcp.h>
+
 using namespace std;
 
 
@@ -84,12 +86,16 @@ int ClientSocket::createTCPSocket() {
                   *getConnectionIP() + ":" + to_string(getConnectionPort()), errno, __CLASS_NAME__));
     };
 
+    // every message is gathered into a single write, so do not let Nagle hold it back
+    int one = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
     return s;
 }
 
 
 ClientSocket::ClientSocket(Schain &_sChain, schain_index _destinationIndex, port_type portType)
-        : bindIP(_sChain.getNode()->getBindIP()) {
+        : bindIP(_sChain.getNode()->getBindIP()), destinationIndex(_destinationIndex), portType(portType) {
     if (_sChain.getNode()->getNodeInfoByIndex(_destinationIndex) == nullptr) {
         BOOST_THROW_EXCEPTION(FatalError("Could not find node with destination index "));
     }
@@ -117,3 +123,28 @@ atomic<int64_t> ClientSocket::totalSockets = 0;
 uint64_t ClientSocket::getTotalSockets() {
     return totalSockets;
 }
+
+schain_index ClientSocket::getDestinationIndex() {
+    return destinationIndex;
+}
+
+port_type ClientSocket::getPortType() {
+    return portType;
+}
+
+bool ClientSocket::isPeerClosed() {
+    LOCK(m)
+
+    if (descriptor == 0)
+        return true;
+
+    char c;
+
+    auto result = recv((int) descriptor, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+
+    if (result == 0)
+        return true;
+
+    // an idle connection has nothing to read, anything else means the exchange got out of sync
+    return result > 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+}
@@ -45,6 +45,10 @@ class ClientSocket {
 
     network_port remotePort;
 
+    schain_index destinationIndex;
+
+    port_type portType;
+
     ptr<sockaddr_in> remote_addr;
 
     ptr<sockaddr_in> bind_addr;
@@ -68,6 +72,13 @@ public:
 
     static uint64_t getTotalSockets();
 
+    schain_index getDestinationIndex();
+
+    port_type getPortType();
+
+    // true if the peer closed an idle connection
+    bool isPeerClosed();
+
 
     virtual ~ClientSocket() {
         closeSocket();
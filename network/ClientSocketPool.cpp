@@ -0,0 +1,84 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+    @file ClientSocketPool.cpp
+    @author Stan Kladko
+    @date 2019
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+
+#include "utils/Time.h"
+#include "ClientSocket.h"
+#include "ClientSocketPool.h"
+
+ClientSocketPool::ClientSocketPool(Schain *_sChain) : sChain(_sChain) {
+    CHECK_ARGUMENT(_sChain);
+    reusedCount = 0;
+    createdCount = 0;
+}
+
+ptr<ClientSocket> ClientSocketPool::acquire(schain_index _dstIndex, port_type _portType) {
+
+    {
+        lock_guard<mutex> lock(m);
+
+        auto &sockets = idleSockets[{(uint64_t) _dstIndex, (uint64_t) _portType}];
+
+        auto now = Time::getCurrentTimeMs();
+
+        while (!sockets.empty()) {
+            auto socket = sockets.back().first;
+            auto lastUsedMs = sockets.back().second;
+            sockets.pop_back();
+
+            // the server closes connections idle for SERVER_REQUEST_WAIT_MS, so do not reuse old ones
+            if (now - lastUsedMs < CLIENT_SOCKET_IDLE_MS && !socket->isPeerClosed()) {
+                reusedCount++;
+                return socket;
+            }
+        }
+    }
+
+    createdCount++;
+
+    return make_shared<ClientSocket>(*sChain, _dstIndex, _portType);
+}
+
+void ClientSocketPool::release(ptr<ClientSocket> _socket) {
+
+    CHECK_ARGUMENT(_socket);
+
+    lock_guard<mutex> lock(m);
+
+    auto &sockets = idleSockets[{(uint64_t) _socket->getDestinationIndex(), (uint64_t) _socket->getPortType()}];
+
+    if (sockets.size() >= MAX_IDLE_SOCKETS_PER_PEER)
+        return;
+
+    sockets.emplace_back(_socket, Time::getCurrentTimeMs());
+}
+
+uint64_t ClientSocketPool::getReusedCount() {
+    return reusedCount;
+}
+
+uint64_t ClientSocketPool::getCreatedCount() {
+    return createdCount;
+}
@@ -0,0 +1,55 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+    @file ClientSocketPool.h
+    @author Stan Kladko
+    @date 2019
+*/
+
+#pragma once
+
+class Schain;
+class ClientSocket;
+
+// Keeps connections to peers open between request/response exchanges, so that proposals,
+// DA proofs, finalize fragments and catchup requests do not pay a TCP handshake each.
+// A socket is checked out for one exchange and returned only if the exchange completed.
+class ClientSocketPool {
+
+    mutex m;
+
+    Schain *sChain;
+
+    // idle sockets by (destination index, port type), most recently used at the back
+    map<pair<uint64_t, uint64_t>, list<pair<ptr<ClientSocket>, uint64_t>>> idleSockets;
+
+    atomic<uint64_t> reusedCount;
+
+    atomic<uint64_t> createdCount;
+
+public:
+
+    explicit ClientSocketPool(Schain *_sChain);
+
+    ptr<ClientSocket> acquire(schain_index _dstIndex, port_type _portType);
+
+    void release(ptr<ClientSocket> _socket);
+
+    uint64_t getReusedCount();
+
+    uint64_t getCreatedCount();
+};
@@ -41,70 +41,92 @@
 #include "chains/Schain.h"
 #include "Buffer.h"
 #include "ServerConnection.h"
+#include "utils/Time.h"
 #include "IO.h"
 
+#include <poll.h>
+#include <climits>
+#include <sys/uio.h>
+
 using namespace std;
 
-void IO::readBytes(ptr<ServerConnection> env, ptr<vector<uint8_t>> _buffer, msg_len len) {
-    return readBytes(env->getDescriptor(), _buffer, len);
+void IO::readBytes(ptr<ServerConnection> env, ptr<vector<uint8_t>> _buffer, msg_len len, uint64_t _timeoutMs) {
+    return readBytes(env->getDescriptor(), _buffer, len, _timeoutMs);
 }
 
-void IO::readBuf(file_descriptor descriptor, ptr<Buffer> buf, msg_len len) {
+void IO::readBuf(file_descriptor descriptor, ptr<Buffer> buf, msg_len len, uint64_t _timeoutMs) {
     CHECK_ARGUMENT(buf != nullptr);
     CHECK_ARGUMENT(len > 0);
     CHECK_ARGUMENT(buf->getSize() >= len);
 
-    return readBytes(descriptor, buf->getBuf(), len);
+    return readBytes(descriptor, buf->getBuf(), len, _timeoutMs);
 }
 
 
-void IO::readBytes(file_descriptor _descriptor, ptr<vector<uint8_t>> _buffer, msg_len _len) {
-    // fd_set read_set;
-    // struct timeval timeout;
-
-    CHECK_ARGUMENT(_buffer != nullptr)
-    CHECK_ARGUMENT(_len > 0)
-    CHECK_ARGUMENT(_buffer->size() >= _len)
+void IO::waitReadable(file_descriptor _descriptor, uint64_t _deadlineMs) {
 
-    int64_t bytesRead = 0;
+    struct pollfd fds[2];
+    fds[0].fd = (int) _descriptor;
+    fds[0].events = POLLIN;
+    fds[1].fd = sChain->getNode()->getExitEventFd();
+    fds[1].events = POLLIN;
 
-    int64_t result;
+    while (true) {
 
+        auto now = Time::getCurrentTimeMs();
 
-    struct timeval tv;
-    tv.tv_sec = 3;
-    tv.tv_usec = 0;
-    setsockopt(int(_descriptor), SOL_SOCKET, SO_RCVTIMEO, (const char *) &tv, sizeof tv);
+        if (now >= _deadlineMs) {
+            BOOST_THROW_EXCEPTION(NetworkProtocolException("Peer read timeout", __CLASS_NAME__));
+        }
 
+        fds[0].revents = 0;
+        fds[1].revents = 0;
 
-    while (msg_len(bytesRead) < _len) {
+        auto result = poll(fds, 2, (int) (_deadlineMs - now));
 
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            BOOST_THROW_EXCEPTION(
+                    NetworkProtocolException("Poll returned error:" + string(strerror(errno)), __CLASS_NAME__));
+        }
 
-        if (sChain->getNode()->isExitRequested())
+        if (fds[1].revents != 0 || sChain->getNode()->isExitRequested())
             BOOST_THROW_EXCEPTION(ExitRequestedException(__CLASS_NAME__));
 
-        uint64_t counter = 1;
+        // hangups and errors are reported by the following recv
+        if (fds[0].revents != 0)
+            return;
+    }
+}
+
 
-        do {
+void IO::readBytes(file_descriptor _descriptor, ptr<vector<uint8_t>> _buffer, msg_len _len, uint64_t _timeoutMs) {
 
-            result = recv(int(_descriptor), _buffer->data() + bytesRead, uint64_t(_len) - bytesRead, 0);
+    CHECK_ARGUMENT(_buffer != nullptr)
+    CHECK_ARGUMENT(_len > 0)
+    CHECK_ARGUMENT(_buffer->size() >= _len)
+    CHECK_ARGUMENT(_timeoutMs > 0)
 
+    if (sChain->getNode()->isExitRequested())
+        BOOST_THROW_EXCEPTION(ExitRequestedException(__CLASS_NAME__));
 
-            if (sChain->getNode()->isExitRequested())
-                BOOST_THROW_EXCEPTION(ExitRequestedException(__CLASS_NAME__));
-            if (result == 0) {
-                usleep(10); // dont do busy wait
-            };
-            counter++;
+    auto deadlineMs = Time::getCurrentTimeMs() + _timeoutMs;
 
-            if (counter > 1000) {
-                BOOST_THROW_EXCEPTION(NetworkProtocolException("Peer read timeout", __CLASS_NAME__));
-            }
+    uint64_t bytesRead = 0;
 
+    while (msg_len(bytesRead) < _len) {
 
-        } while (result <= 0 && errno == EAGAIN);
+        auto result = recv(int(_descriptor), _buffer->data() + bytesRead, uint64_t(_len) - bytesRead,
+                           MSG_DONTWAIT);
 
         if (result < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                waitReadable(_descriptor, deadlineMs);
+                continue;
+            }
+            if (errno == EINTR)
+                continue;
             BOOST_THROW_EXCEPTION(
                     NetworkProtocolException("Read returned error:" + string(strerror(errno)), __CLASS_NAME__));
         }
@@ -112,16 +134,12 @@ void IO::readBytes(file_descriptor _descriptor, ptr<vector<uint8_t>> _buffer, ms
         if (result == 0) {
             BOOST_THROW_EXCEPTION(NetworkProtocolException("The peer shut down the socket, bytes to read:" +
                                                            to_string(uint64_t(_len) - bytesRead), __CLASS_NAME__));
-
         }
 
         bytesRead += result;
-
-        // LOG(trace, "IO bytes read:" + to_string( bytesRead ) );
     }
 
-    assert ((uint64_t ) bytesRead == (uint64_t ) _len);
-
+    assert (bytesRead == (uint64_t) _len);
 }
 
 
@@ -130,32 +148,73 @@ void IO::writeBytes(file_descriptor descriptor, ptr<vector<uint8_t>> _buffer, ms
     CHECK_ARGUMENT(_buffer != nullptr);
     CHECK_ARGUMENT(!_buffer->empty());
     CHECK_ARGUMENT(len <= _buffer->size())
+    CHECK_ARGUMENT(len > 0);
 
+    auto iov = vector<struct iovec>(1);
+    iov[0].iov_base = _buffer->data();
+    iov[0].iov_len = (uint64_t) len;
 
-    usleep(sChain->getNode()->getSimulateNetworkWriteDelayMs() * 1000);
+    writeIovecs(descriptor, iov);
+}
 
-    CHECK_ARGUMENT(_buffer != nullptr);
-    CHECK_ARGUMENT(len > 0);
-    CHECK_ARGUMENT(descriptor != 0);
 
-    //    setsockopt( int( descriptor ), SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof( int ) );
+void IO::writeBytesV(file_descriptor _descriptor, const vector<ptr<vector<uint8_t>>> &_buffers) {
 
-    uint64_t bytesWritten = 0;
+    auto iov = vector<struct iovec>();
+    iov.reserve(_buffers.size());
 
-    while (msg_len(bytesWritten) < len) {
-        int64_t result =
-                write((int) descriptor, _buffer->data() + bytesWritten, (uint64_t) len - bytesWritten);
+    for (auto &&buffer : _buffers) {
+        CHECK_ARGUMENT(buffer != nullptr);
+        if (buffer->empty())
+            continue;
+        struct iovec v;
+        v.iov_base = buffer->data();
+        v.iov_len = buffer->size();
+        iov.push_back(v);
+    }
+
+    CHECK_ARGUMENT(!iov.empty());
+
+    writeIovecs(_descriptor, iov);
+}
 
 
+void IO::writeIovecs(file_descriptor _descriptor, vector<struct iovec> &_iov) {
+
+    CHECK_ARGUMENT(_descriptor != 0);
+
+    usleep(sChain->getNode()->getSimulateNetworkWriteDelayMs() * 1000);
+
+    uint64_t first = 0;
+
+    while (first < _iov.size()) {
+
+        auto count = min(_iov.size() - first, (uint64_t) IOV_MAX);
+
+        int64_t result = writev((int) _descriptor, _iov.data() + first, (int) count);
+
         if (sChain->getNode()->isExitRequested())
             BOOST_THROW_EXCEPTION(ExitRequestedException(__CLASS_NAME__));
 
+        if (result < 0 && errno == EINTR)
+            continue;
+
         if (result < 1) {
             BOOST_THROW_EXCEPTION(IOException("Could not write bytes", errno, __CLASS_NAME__));
         }
 
+        // skip what was written, a partially written iovec is advanced in place
+        uint64_t written = result;
+
+        while (first < _iov.size() && written >= _iov[first].iov_len) {
+            written -= _iov[first].iov_len;
+            first++;
+        }
 
-        bytesWritten += result;
+        if (written > 0) {
+            _iov[first].iov_base = (uint8_t *) _iov[first].iov_base + written;
+            _iov[first].iov_len -= written;
+        }
     }
 }
 
@@ -167,38 +226,54 @@ void IO::writeBuf(file_descriptor descriptor, ptr<Buffer> buf) {
     writeBytes(descriptor, buf->getBuf(), msg_len(buf->getCounter()));
 }
 
-void IO::writeMagic(ptr<ClientSocket> _socket, bool _isPing) {
+ptr<vector<uint8_t>> IO::getMagicBytes(bool _isPing) {
 
+    static auto createMagicBytes = [](uint64_t _magic) {
+        auto buf = make_shared<vector<uint8_t>>(sizeof(_magic));
+        memcpy(buf->data(), &_magic, sizeof(_magic));
+        return buf;
+    };
 
-    uint64_t magic;
+    // written from many threads, never modified
+    static auto magicBytes = createMagicBytes(MAGIC_NUMBER);
+    static auto pingBytes = createMagicBytes(TEST_MAGIC_NUMBER);
 
-    if (_isPing) {
-        magic = TEST_MAGIC_NUMBER;
-    } else {
-        magic = MAGIC_NUMBER;
-    }
+    return _isPing ? pingBytes : magicBytes;
+}
 
-    auto buf = make_shared<vector<uint8_t>>(sizeof(magic));
+void IO::writeMagic(ptr<ClientSocket> _socket, bool _isPing) {
+    writeBytesVector(_socket->getDescriptor(), getMagicBytes(_isPing));
+}
 
 
-    memcpy(buf->data(), &magic, sizeof(magic));
+void IO::writeHeader(ptr<ClientSocket> socket, ptr<Header> header, ptr<vector<uint8_t>> _body) {
+    CHECK_ARGUMENT(socket);
+    writeMessage(socket->getDescriptor(), false, header, _body);
+}
 
-    try {
-        writeBytesVector(_socket->getDescriptor(), buf);
-    } catch (ExitRequestedException &) { throw; }
+void IO::writeRequest(ptr<ClientSocket> _socket, ptr<Header> _header, ptr<vector<uint8_t>> _body) {
+    CHECK_ARGUMENT(_socket);
+    writeMessage(_socket->getDescriptor(), true, _header, _body);
+}
 
-    catch (...) {
-        throw;
-    }
+void IO::writeMessage(file_descriptor _descriptor, bool _withMagic, ptr<Header> _header,
+                      ptr<vector<uint8_t>> _body) {
+    CHECK_ARGUMENT(_header);
+    CHECK_ARGUMENT(_header->isComplete());
 
-}
+    auto buffers = vector<ptr<vector<uint8_t>>>();
+    buffers.reserve(3);
 
+    if (_withMagic)
+        buffers.push_back(getMagicBytes(false));
 
-void IO::writeHeader(ptr<ClientSocket> socket, ptr<Header> header) {
-    CHECK_ARGUMENT(socket);
-    CHECK_ARGUMENT(header);
-    CHECK_ARGUMENT(header->isComplete());
-    writeBuf(socket->getDescriptor(), header->toBuffer());
+    // the header buffer holds the length prefix and the JSON
+    buffers.push_back(_header->toBuffer()->getBuf());
+
+    if (_body)
+        buffers.push_back(_body);
+
+    writeBytesV(_descriptor, buffers);
 }
 
 void IO::writeBytesVector(file_descriptor socket, ptr<vector<uint8_t> > bytes) {
@@ -207,6 +282,10 @@ void IO::writeBytesVector(file_descriptor socket, ptr<vector<uint8_t> > bytes) {
 
 void IO::writePartialHashes(
         file_descriptor socket, ptr<map<uint64_t, ptr<partial_sha_hash>>> hashes) {
+    return writeBytesVector(socket, serializePartialHashes(hashes));
+}
+
+ptr<vector<uint8_t>> IO::serializePartialHashes(ptr<map<uint64_t, ptr<partial_sha_hash>>> hashes) {
     CHECK_ARGUMENT(hashes->size() > 0);
 
     auto buffer = make_shared<vector<uint8_t> >(hashes->size() * PARTIAL_SHA_HASH_LEN);
@@ -218,7 +297,7 @@ void IO::writePartialHashes(
         counter++;
     }
 
-    return writeBytesVector(socket, buffer);
+    return buffer;
 }
 
 IO::IO(Schain *_sChain) : sChain(_sChain) {
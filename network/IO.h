@@ -43,23 +43,44 @@ class IO {
 private:
 
     Schain *sChain;
+
+    // waits until the descriptor is readable, the deadline passes or exit is requested
+    void waitReadable(file_descriptor _descriptor, uint64_t _deadlineMs);
+
+    void writeIovecs(file_descriptor _descriptor, vector<struct iovec> &_iov);
+
+    static ptr<vector<uint8_t>> getMagicBytes(bool _isPing);
+
 public:
     IO(Schain *_sChain);
 
 public:
 
-    void readBytes(ptr<ServerConnection> _env, ptr<vector<uint8_t>> _buffer, msg_len _len);
+    // the timeout is a deadline for the whole read, not for each recv
+    void readBytes(ptr<ServerConnection> _env, ptr<vector<uint8_t>> _buffer, msg_len _len,
+                   uint64_t _timeoutMs = NETWORK_READ_TIMEOUT_MS);
 
-    void readBytes(file_descriptor _descriptor, ptr<vector<uint8_t>> _buffer, msg_len _len);
+    void readBytes(file_descriptor _descriptor, ptr<vector<uint8_t>> _buffer, msg_len _len,
+                   uint64_t _timeoutMs = NETWORK_READ_TIMEOUT_MS);
 
-    void readBuf(file_descriptor _descriptor, ptr<Buffer> _buf, msg_len _len);
+    void readBuf(file_descriptor _descriptor, ptr<Buffer> _buf, msg_len _len,
+                 uint64_t _timeoutMs = NETWORK_READ_TIMEOUT_MS);
 
     void writeBytes(file_descriptor descriptor, ptr<vector<uint8_t>> _buffer, msg_len len);
 
+    // writes the buffers back to back with writev
+    void writeBytesV(file_descriptor _descriptor, const vector<ptr<vector<uint8_t>>> &_buffers);
+
     void writeBuf(file_descriptor _descriptor, ptr<Buffer> _buf);
 
 
-    void writeHeader(ptr<ClientSocket> _socket, ptr<Header> _header);
+    void writeHeader(ptr<ClientSocket> _socket, ptr<Header> _header, ptr<vector<uint8_t>> _body = nullptr);
+
+    // magic, header and optional body in one writev, starts an exchange on the socket
+    void writeRequest(ptr<ClientSocket> _socket, ptr<Header> _header, ptr<vector<uint8_t>> _body = nullptr);
+
+    void writeMessage(file_descriptor _descriptor, bool _withMagic, ptr<Header> _header,
+                      ptr<vector<uint8_t>> _body);
 
 
 
@@ -71,6 +92,8 @@ public:
 
     void writePartialHashes(file_descriptor socket, ptr<map<uint64_t, ptr<partial_sha_hash>>> hashes);
 
+    static ptr<vector<uint8_t>> serializePartialHashes(ptr<map<uint64_t, ptr<partial_sha_hash>>> hashes);
+
 
     void readMagic(file_descriptor descriptor);
 
@@ -0,0 +1,98 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file PeerSendQueue.cpp
+    @author Stan Kladko
+    @date 2019
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+
+#include "PeerSendQueue.h"
+
+
+PeerSendQueue::PeerSendQueue(uint64_t _maxSize) : maxSize(_maxSize) {
+    CHECK_ARGUMENT(_maxSize > 0);
+}
+
+ptr<OutgoingFrame> PeerSendQueue::push(const ptr<OutgoingFrame> &_frame) {
+
+    CHECK_ARGUMENT(_frame);
+
+    ptr<OutgoingFrame> evicted = nullptr;
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+
+        // the front frame may be in flight, so the next oldest one is evicted
+        if (frames.size() >= maxSize && frames.size() > 1) {
+            evicted = frames.at(1);
+            frames.erase(frames.begin() + 1);
+            totalEvicted++;
+        }
+
+        frames.push_back(_frame);
+    }
+
+    queueCond.notify_one();
+
+    return evicted;
+}
+
+ptr<OutgoingFrame> PeerSendQueue::waitForFront(uint64_t _timeoutMs) {
+
+    unique_lock<mutex> lock(queueMutex);
+
+    if (frames.empty()) {
+        queueCond.wait_for(lock, chrono::milliseconds(_timeoutMs));
+    }
+
+    if (frames.empty())
+        return nullptr;
+
+    return frames.front();
+}
+
+void PeerSendQueue::popSent(const ptr<OutgoingFrame> &_frame) {
+
+    lock_guard<mutex> lock(queueMutex);
+
+    CHECK_STATE(!frames.empty() && frames.front() == _frame);
+
+    frames.pop_front();
+
+    totalSent++;
+}
+
+void PeerSendQueue::wakeUp() {
+    queueCond.notify_all();
+}
+
+uint64_t PeerSendQueue::getDepth() {
+    lock_guard<mutex> lock(queueMutex);
+    return frames.size();
+}
+
+uint64_t PeerSendQueue::getTotalSent() const {
+    return totalSent;
+}
+
+uint64_t PeerSendQueue::getTotalEvicted() const {
+    return totalEvicted;
+}
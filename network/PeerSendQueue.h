@@ -0,0 +1,73 @@
+/*
+    Copyright (C) 2019 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file PeerSendQueue.h
+    @author Stan Kladko
+    @date 2019
+*/
+
+#pragma once
+
+class NetworkMessage;
+class BroadcastQuorum;
+
+class OutgoingFrame {
+public:
+    ptr<string> data;
+
+    // messages carried by the frame, queued to delayed sends if the frame is evicted
+    vector<ptr<NetworkMessage>> messages;
+
+    ptr<BroadcastQuorum> quorum;
+};
+
+// bounded queue of frames waiting to be sent to one peer by its sender thread
+class PeerSendQueue {
+
+    uint64_t maxSize;
+
+    mutex queueMutex;
+
+    condition_variable queueCond;
+
+    deque<ptr<OutgoingFrame>> frames;
+
+    atomic<uint64_t> totalSent = 0;
+
+    atomic<uint64_t> totalEvicted = 0;
+
+public:
+
+    explicit PeerSendQueue(uint64_t _maxSize);
+
+    // returns the oldest frame if it had to be evicted to make room
+    ptr<OutgoingFrame> push(const ptr<OutgoingFrame> &_frame);
+
+    // waits up to _timeoutMs for a frame, which stays queued until popSent()
+    ptr<OutgoingFrame> waitForFront(uint64_t _timeoutMs);
+
+    void popSent(const ptr<OutgoingFrame> &_frame);
+
+    void wakeUp();
+
+    uint64_t getDepth();
+
+    uint64_t getTotalSent() const;
+
+    uint64_t getTotalEvicted() const;
+};
@@ -30,6 +30,7 @@
 #include "abstracttcpserver/ConnectionStatus.h"
 #include "blockproposal/pusher/BlockProposalClientAgent.h"
 #include "db/BlockProposalDB.h"
+#include "db/ConsensusStateDB.h"
 #include "blockproposal/server/BlockProposalWorkerThreadPool.h"
 #include "chains/Schain.h"
 #include "crypto/ConsensusBLSSigShare.h"
@@ -37,6 +38,7 @@
 #include "datastructures/BlockProposal.h"
 #include "exceptions/FatalError.h"
 #include "messages/NetworkMessage.h"
+#include "messages/NetworkMessageFields.h"
 #include "node/Node.h"
 #include "node/NodeInfo.h"
 #include "protocols/binconsensus/AUXBroadcastMessage.h"
@@ -59,68 +61,110 @@
 #include "network/Sockets.h"
 #include "network/ZMQServerSocket.h"
 #include "Buffer.h"
+#include "BroadcastQuorum.h"
+#include "PeerSendQueue.h"
 #include "TransportNetwork.h"
 
 TransportType TransportNetwork::transport = TransportType::ZMQ;
 
+thread_local TransportNetwork::PendingSends TransportNetwork::pendingSends;
 
-void TransportNetwork::addToDeferredMessageQueue(ptr<NetworkMessageEnvelope> _me) {
+
+void TransportNetwork::addToDeferredMessageQueue(ptr<NetworkMessageEnvelope> _me, uint64_t _wakeupCounter) {
     CHECK_ARGUMENT(_me);
 
     auto msg = dynamic_pointer_cast<NetworkMessage>(_me->getMessage());
 
+    CHECK_STATE(msg);
 
+    auto key = make_pair(msg->getBlockID(), msg->getRound());
 
-    auto _blockID = _me->getMessage()->getBlockID();
-
-    ptr<vector<ptr<NetworkMessageEnvelope> > > messageList;
+    bool missedWakeup = false;
 
     {
         lock_guard<recursive_mutex> l(deferredMessageMutex);
 
-        if (deferredMessageQueue.count(_blockID) == 0) {
+        auto &messageList = deferredMessageQueue[key];
+
+        if (!messageList) {
             messageList = make_shared<vector<ptr<NetworkMessageEnvelope>>>();
-            deferredMessageQueue[_blockID] = messageList;
-        } else {
-            messageList = deferredMessageQueue[_blockID];
-        };
+        }
 
         messageList->push_back(_me);
+
+        // a wakeup came in while the message was checked, so it may be ready already
+        if (deferWakeupCounter != _wakeupCounter) {
+            commitWakeup = true;
+            missedWakeup = true;
+        }
     }
-}
 
-ptr<vector<ptr<NetworkMessageEnvelope> > > TransportNetwork::pullMessagesForCurrentBlockID() {
+    if (missedWakeup) {
+        deferredMessageCond.notify_all();
+    }
+}
 
+void TransportNetwork::notifyBlockCommitted() {
+    {
+        lock_guard<recursive_mutex> l(deferredMessageMutex);
+        commitWakeup = true;
+        deferWakeupCounter++;
+    }
+    deferredMessageCond.notify_all();
+}
 
-    LOCK(deferredMessageMutex);
+void TransportNetwork::notifyRoundAdvanced(block_id _blockID, bin_consensus_round _round) {
+    {
+        lock_guard<recursive_mutex> l(deferredMessageMutex);
+        roundWakeups.emplace_back(_blockID, _round);
+        deferWakeupCounter++;
+    }
+    deferredMessageCond.notify_all();
+}
 
+ptr<vector<ptr<NetworkMessageEnvelope> > > TransportNetwork::pullReadyMessages(uint64_t _timeoutMs) {
 
-    block_id currentBlockID = sChain->getLastCommittedBlockID() + 1;
+    unique_lock<recursive_mutex> lock(deferredMessageMutex);
 
+    auto hasWakeup = deferredMessageCond.wait_for(lock, chrono::milliseconds(_timeoutMs), [this] {
+        return commitWakeup || !roundWakeups.empty() || getSchain()->getNode()->isExitRequested();
+    });
 
     auto returnList = make_shared<vector<ptr<NetworkMessageEnvelope>>>();
 
+    auto release = [&](decltype(deferredMessageQueue)::iterator _begin,
+                       decltype(deferredMessageQueue)::iterator _end) {
+        for (auto it = _begin; it != _end; ++it) {
+            returnList->insert(returnList->end(), it->second->begin(), it->second->end());
+        }
+        deferredMessageQueue.erase(_begin, _end);
+    };
 
-    for (auto it = deferredMessageQueue.cbegin();
-         it != deferredMessageQueue.cend() /* not hoisted */;
-        /* no increment */ ) {
-        if (it->first <= currentBlockID) {
-            for (auto &&msg : *(it->second)) {
-                returnList->push_back(msg);
-            }
+    block_id currentBlockID = sChain->getLastCommittedBlockID() + 1;
 
-            it = deferredMessageQueue.erase(it);
-        } else {
-            ++it;
+    // a timeout without wakeups releases everything current as well, as a safety net
+    if (commitWakeup || !hasWakeup) {
+        release(deferredMessageQueue.begin(),
+                deferredMessageQueue.lower_bound(make_pair(currentBlockID + 1, bin_consensus_round(0))));
+    } else {
+        for (auto &&wakeup : roundWakeups) {
+            // messages of the next round can be accepted once the current one is decided
+            release(deferredMessageQueue.lower_bound(make_pair(wakeup.first, bin_consensus_round(0))),
+                    deferredMessageQueue.upper_bound(make_pair(wakeup.first, wakeup.second + 1)));
         }
     }
 
+    commitWakeup = false;
+    roundWakeups.clear();
+
     return returnList;
 }
 
 void TransportNetwork::addToDelayedSends(ptr<NetworkMessage> _m, ptr<NodeInfo> dstNodeInfo) {
     CHECK_ARGUMENT(_m);
     CHECK_ARGUMENT(dstNodeInfo);
+    if (_m->getBlockID() <= getSchain()->getLastCommittedBlockID())
+        return;
     lock_guard<recursive_mutex> lock(delayedSendsLock);
     auto dstIndex = (uint64_t) dstNodeInfo->getSchainIndex();
     delayedSends.at(dstIndex - 1).push_back({_m, dstNodeInfo});
@@ -129,7 +173,7 @@ void TransportNetwork::addToDelayedSends(ptr<NetworkMessage> _m, ptr<NodeInfo> d
     }
 }
 
-void TransportNetwork::broadcastMessage(ptr<NetworkMessage> _m) {
+void TransportNetwork::broadcastMessage(ptr<NetworkMessage> _m, function<void()> _onQuorum) {
 
 
     if (_m->getBlockID() <= this->catchupBlocks) {
@@ -138,40 +182,225 @@ void TransportNetwork::broadcastMessage(ptr<NetworkMessage> _m) {
 
     try {
 
+        if (isSendBatching()) {
+            // nothing is sent before commitSendBatch(), which runs after the state batch is committed
+            // and waits once for the journal
+            getSchain()->getNode()->getOutgoingMsgDB()->saveMsgAsync(_m);
+            pendingSends.messages.push_back(_m);
+            pendingSends.callbacks.push_back(_onQuorum);
+            return;
+        }
+
         getSchain()->getNode()->getOutgoingMsgDB()->saveMsg(_m);
 
-        unordered_set<uint64_t> sent;
+        // the state that caused this message has to be on disk before the message is sent
+        getSchain()->getNode()->getConsensusStateDB()->flushBatch();
+
+        auto frame = make_shared<OutgoingFrame>();
+        frame->data = getSchain()->getNode()->isBinaryNetworkMessages() ? _m->serializeToBinary() :
+                      _m->serializeToString();
+        frame->messages.push_back(_m);
+
+        vector<function<void()>> callbacks;
+        if (_onQuorum)
+            callbacks.push_back(_onQuorum);
+
+        frame->quorum = make_shared<BroadcastQuorum>((uint64_t) getSchain()->getNodeCount(), move(callbacks));
+
+        enqueueFrame(frame);
+
+    } catch (...) {
+        throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
+    }
+
+}
+
+void TransportNetwork::enqueueFrame(const ptr<OutgoingFrame> &_frame) {
+
+    CHECK_ARGUMENT(_frame);
 
-        // wait until we send to at least 2/3 of participants
-        while (3 * (sent.size() + 1) < getSchain()->getNodeCount() * 2) {
-            for (auto const &it : *getSchain()->getNode()->getNodeInfosByIndex()) {
-                auto dstNodeInfo = it.second;
-                auto dstIndex = (uint64_t) dstNodeInfo->getSchainIndex();
+    for (auto const &it : *getSchain()->getNode()->getNodeInfosByIndex()) {
+        auto dstIndex = (uint64_t) it.second->getSchainIndex();
 
-                if (dstIndex != (getSchain()->getSchainIndex()) && !sent.count(dstIndex)) {
-                    if (sendMessage(it.second, _m)) {
-                        sent.insert(dstIndex);
+        if (dstIndex == (getSchain()->getSchainIndex()))
+            continue;
+
+        auto evicted = peerSendQueues.at(dstIndex - 1)->push(_frame);
+
+        // the peer is too far behind. Its oldest frame goes to delayed sends,
+        // which are retried later
+        if (evicted) {
+            for (auto &&msg : evicted->messages) {
+                addToDelayedSends(msg, it.second);
+            }
+        }
+    }
+}
+
+void TransportNetwork::peerSendLoop(schain_index _dstIndex) {
+
+    setThreadName("PeerSend" + to_string((uint64_t) _dstIndex), getSchain()->getNode()->getConsensusEngine());
+
+    waitOnGlobalStartBarrier();
+
+    auto queue = peerSendQueues.at((uint64_t) _dstIndex - 1);
+
+    try {
+        auto dstNodeInfo = getSchain()->getNode()->getNodeInfoByIndex(_dstIndex);
+        CHECK_STATE(dstNodeInfo);
+
+        while (!getSchain()->getNode()->isExitRequested()) {
+            try {
+                auto frame = queue->waitForFront(PEER_SEND_WAIT_MS);
+
+                if (!frame) {
+                    // nothing new to send, so retransmit the backlog once the peer is writable again
+                    if (getDelayedSendsBacklog(_dstIndex) > 0 && waitUntilWritable(dstNodeInfo, PEER_SEND_WAIT_MS)) {
+                        trySendingDelayedSends(dstNodeInfo);
                     }
+                    continue;
                 }
+
+                if (!sendFrame(dstNodeInfo, frame->data)) {
+                    // the peer is not taking messages, wait for it instead of spinning
+                    waitUntilWritable(dstNodeInfo, MAX_PEER_SEND_BACKOFF_MS);
+                    continue;
+                }
+
+                queue->popSent(frame);
+
+                if (frame->quorum)
+                    frame->quorum->peerSent();
+
+                // the peer is taking messages, flush whatever it missed
+                if (getDelayedSendsBacklog(_dstIndex) > 0) {
+                    trySendingDelayedSends(dstNodeInfo);
+                }
+
+            } catch (ExitRequestedException &) {
+                return;
+            } catch (FatalError &) {
+                throw;
+            } catch (exception &e) {
+                if (getSchain()->getNode()->isExitRequested())
+                    return;
+                Exception::logNested(e);
+                usleep(1000 * MAX_PEER_SEND_BACKOFF_MS);
             }
         }
+    } catch (FatalError &e) {
+        getSchain()->getNode()->exitOnFatalError(e.getMessage());
+    }
+}
+
+uint64_t TransportNetwork::getPeerSendQueueDepth(schain_index _dstIndex) {
+    CHECK_ARGUMENT(_dstIndex > 0 && (uint64_t) _dstIndex <= peerSendQueues.size());
+    return peerSendQueues.at((uint64_t) _dstIndex - 1)->getDepth();
+}
+
+uint64_t TransportNetwork::getTotalSendQueueDepth() {
+    uint64_t total = 0;
+    for (auto &&queue : peerSendQueues) {
+        total += queue->getDepth();
+    }
+    return total;
+}
+
+bool TransportNetwork::isSendBatching() const {
+    return pendingSends.owner == this;
+}
+
+void TransportNetwork::startSendBatch() {
+    // old nodes can not unpack batches
+    if (!getSchain()->getNode()->isBinaryNetworkMessages())
+        return;
+    CHECK_STATE(pendingSends.owner == nullptr || isSendBatching());
+    pendingSends.owner = this;
+}
+
+ptr<vector<ptr<string>>> TransportNetwork::packFrames(const vector<ptr<NetworkMessage>> &_messages,
+                                                      vector<uint64_t> &_framesEnd) {
+
+    auto frames = make_shared<vector<ptr<string>>>();
+
+    // batch header plus a varint length per message
+    static constexpr uint64_t BATCH_HEADER_LEN = 16;
+    static constexpr uint64_t BATCH_LENGTH_LEN = 10;
+
+    vector<ptr<string>> frameMessages;
+    uint64_t frameSize = BATCH_HEADER_LEN;
+
+    for (uint64_t i = 0; i < _messages.size(); i++) {
+        auto s = _messages.at(i)->serializeToBinary();
+
+        if (!frameMessages.empty() && frameSize + s->size() + BATCH_LENGTH_LEN >= MAX_CONSENSUS_FRAME_LEN) {
+            frames->push_back(NetworkMessageFields::packBatch(frameMessages));
+            _framesEnd.push_back(i);
+            frameMessages.clear();
+            frameSize = BATCH_HEADER_LEN;
+        }
+
+        frameSize += s->size() + BATCH_LENGTH_LEN;
+        frameMessages.push_back(s);
+    }
+
+    if (frameMessages.size() == 1) {
+        frames->push_back(frameMessages.front());
+    } else if (!frameMessages.empty()) {
+        frames->push_back(NetworkMessageFields::packBatch(frameMessages));
+    }
+
+    _framesEnd.push_back(_messages.size());
+
+    return frames;
+}
+
+void TransportNetwork::commitSendBatch() {
+
+    if (!isSendBatching())
+        return;
 
-        // messages that could not be sent because the receiving nodes were not online are
-        // queued to delayed sends to be tried later. The delayed sends queue for
-        // each destination can have MAX_DELAYED_MESSAGE_SENDS
+    auto messages = move(pendingSends.messages);
+    auto callbacks = move(pendingSends.callbacks);
+    pendingSends.messages.clear();
+    pendingSends.callbacks.clear();
+    pendingSends.owner = nullptr;
 
-        for (auto const &it : *getSchain()->getNode()->getNodeInfosByIndex()) {
-            auto dstNodeInfo = it.second;
-            auto dstIndex = (uint64_t) dstNodeInfo->getSchainIndex();
-            if (dstIndex != (getSchain()->getSchainIndex()) && !sent.count(dstIndex)) {
-                addToDelayedSends(_m, dstNodeInfo);
+    if (messages.empty())
+        return;
+
+    try {
+
+        // the whole batch was journaled asynchronously, it has to be on disk before it is sent
+        getSchain()->getNode()->getOutgoingMsgDB()->flush();
+
+        vector<uint64_t> framesEnd;
+        auto frames = packFrames(messages, framesEnd);
+
+        uint64_t begin = 0;
+
+        for (uint64_t i = 0; i < frames->size(); i++) {
+            auto frame = make_shared<OutgoingFrame>();
+            frame->data = frames->at(i);
+
+            vector<function<void()>> frameCallbacks;
+
+            for (auto j = begin; j < framesEnd.at(i); j++) {
+                frame->messages.push_back(messages.at(j));
+                if (callbacks.at(j))
+                    frameCallbacks.push_back(callbacks.at(j));
             }
+
+            frame->quorum = make_shared<BroadcastQuorum>((uint64_t) getSchain()->getNodeCount(), move(frameCallbacks));
+
+            enqueueFrame(frame);
+
+            begin = framesEnd.at(i);
         }
 
     } catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
     }
-
 }
 
 void TransportNetwork::networkReadLoop() {
@@ -181,20 +410,21 @@ void TransportNetwork::networkReadLoop() {
     try {
         while (!sChain->getNode()->isExitRequested()) {
             try {
-                ptr<NetworkMessageEnvelope> m = receiveMessage();
+                auto messages = receiveMessages();
 
-                if (!m)
-                    continue;  // check exit again
+                for (auto &&m : *messages) {
 
-                if (m->getMessage()->getBlockID() <= catchupBlocks) {
-                    continue;
-                }
+                    if (m->getMessage()->getBlockID() <= catchupBlocks) {
+                        continue;
+                    }
 
-                ASSERT(sChain);
+                    ASSERT(sChain);
 
-                getSchain()->getNode()->getIncomingMsgDB()->saveMsg(dynamic_pointer_cast<NetworkMessage>(m->getMessage()));
+                    getSchain()->getNode()->getIncomingMsgDB()->saveMsgAsync(
+                            dynamic_pointer_cast<NetworkMessage>(m->getMessage()));
 
-                postDeferOrDrop(m);
+                    postDeferOrDrop(m);
+                }
             } catch (ExitRequestedException &) {
                 return;
             } catch (FatalError &) {
@@ -224,6 +454,8 @@ void TransportNetwork::networkReadLoop() {
  */
 void TransportNetwork::postDeferOrDrop(const ptr<NetworkMessageEnvelope> &m) {
 
+    uint64_t wakeupCounter = deferWakeupCounter;
+
     block_id currentBlockID = sChain->getLastCommittedBlockID() + 1;
 
 
@@ -231,7 +463,7 @@ void TransportNetwork::postDeferOrDrop(const ptr<NetworkMessageEnvelope> &m) {
 
     if (bid > currentBlockID) {
         // block id is in the future, defer
-        addToDeferredMessageQueue(m);
+        addToDeferredMessageQueue(m, wakeupCounter);
         return;
     }
 
@@ -249,32 +481,76 @@ void TransportNetwork::postDeferOrDrop(const ptr<NetworkMessageEnvelope> &m) {
     if (sChain->getBlockConsensusInstance()->shouldPost(msg)) {
         sChain->postMessage(m);
     } else {
-        addToDeferredMessageQueue(m);
+        addToDeferredMessageQueue(m, wakeupCounter);
     }
 
 }
 
-void TransportNetwork::trySendingDelayedSends() {
-    auto nodeCount = getSchain()->getNodeCount();
-    auto schainIndex = getSchain()->getSchainIndex();
+uint64_t TransportNetwork::trySendingDelayedSends(const ptr<NodeInfo> &_dstNodeInfo) {
 
-    for (int i = 0; i < nodeCount; i++) {
-        if (i != (schainIndex - 1)) {
-            lock_guard<recursive_mutex> lock(delayedSendsLock);
-            while (delayedSends.at(i).size() > 0) {
-                auto msg = delayedSends.at(i).front().second;
-                auto dstNodeInfo = delayedSends.at(i).front().first;
-                if (sendMessage(msg, dstNodeInfo)) {
-                    // successfully sent a delayed message, remove it from the list
-                    delayedSends.at(i).pop_front();
-                } {
-                    // could not send a message to this host, no point trying to
-                    // send other delayed messages for this host
-                    break;
-                }
-            }
+    CHECK_ARGUMENT(_dstNodeInfo);
+
+    auto i = (uint64_t) _dstNodeInfo->getSchainIndex() - 1;
+
+    std::list<pair<ptr<NetworkMessage>, ptr<NodeInfo>>> pending;
+
+    {
+        lock_guard<recursive_mutex> lock(delayedSendsLock);
+        pending.swap(delayedSends.at(i));
+    }
+
+    if (pending.empty())
+        return 0;
+
+    auto lastCommittedBlockID = getSchain()->getLastCommittedBlockID();
+
+    uint64_t sentCount = 0;
+
+    while (!pending.empty()) {
+        auto msg = pending.front().first;
+
+        // the peer will get committed blocks through catchup
+        if (msg->getBlockID() <= lastCommittedBlockID) {
+            pending.pop_front();
+            continue;
+        }
+
+        if (!sendMessage(_dstNodeInfo, msg)) {
+            // could not send a message to this host, no point trying to
+            // send other delayed messages for this host
+            break;
+        }
+
+        pending.pop_front();
+        sentCount++;
+    }
+
+    if (!pending.empty()) {
+        lock_guard<recursive_mutex> lock(delayedSendsLock);
+        auto &delayed = delayedSends.at(i);
+        // older messages go first, and the oldest ones are dropped on overflow
+        delayed.splice(delayed.begin(), pending);
+        while (delayed.size() > MAX_DELAYED_MESSAGE_SENDS) {
+            delayed.pop_front();
         }
     }
+
+    return sentCount;
+}
+
+uint64_t TransportNetwork::getDelayedSendsBacklog(schain_index _dstIndex) {
+    CHECK_ARGUMENT(_dstIndex > 0 && (uint64_t) _dstIndex <= delayedSends.size());
+    lock_guard<recursive_mutex> lock(delayedSendsLock);
+    return delayedSends.at((uint64_t) _dstIndex - 1).size();
+}
+
+uint64_t TransportNetwork::getTotalDelayedSendsBacklog() {
+    lock_guard<recursive_mutex> lock(delayedSendsLock);
+    uint64_t total = 0;
+    for (auto &&delayed : delayedSends) {
+        total += delayed.size();
+    }
+    return total;
 }
 
 void TransportNetwork::deferredMessagesLoop() {
@@ -286,14 +562,12 @@ void TransportNetwork::deferredMessagesLoop() {
         try {
             ptr<vector<ptr<NetworkMessageEnvelope> > > deferredMessages;
 
-            // Get messages for the current block id
-            deferredMessages = pullMessagesForCurrentBlockID();
+            // wait for a commit or a round change to release deferred messages
+            deferredMessages = pullReadyMessages(DEFERRED_MESSAGES_WAIT_MS);
 
             for (auto message : *deferredMessages) {
                 postDeferOrDrop(message);
             }
-
-            trySendingDelayedSends();
         }
         catch (ExitRequestedException &) {
             // exit
@@ -303,7 +577,6 @@ void TransportNetwork::deferredMessagesLoop() {
             // print the error and continue the loop
             Exception::logNested(e);
         }
-        usleep(100000);
     }
 }
 
@@ -318,6 +591,14 @@ void TransportNetwork::startThreads() {
 
     reg->add(networkReadThread);
     reg->add(deferredMessageThread);
+
+    for (uint64_t i = 1; i <= peerSendQueues.size(); i++) {
+        if (i == (uint64_t) getSchain()->getSchainIndex())
+            continue;
+        auto peerSendThread = make_shared<thread>(std::bind(&TransportNetwork::peerSendLoop, this, schain_index(i)));
+        peerSendThreads.push_back(peerSendThread);
+        reg->add(peerSendThread);
+    }
 }
 
 bool TransportNetwork::validateIpAddress(ptr<string> &ip) {
@@ -330,6 +611,12 @@ bool TransportNetwork::validateIpAddress(ptr<string> &ip) {
 void TransportNetwork::waitUntilExit() {
     networkReadThread->join();
     deferredMessageThread->join();
+    for (auto &&queue : peerSendQueues) {
+        queue->wakeUp();
+    }
+    for (auto &&peerSendThread : peerSendThreads) {
+        peerSendThread->join();
+    }
 }
 
 ptr<string> TransportNetwork::ipToString(uint32_t _ip) {
@@ -339,13 +626,38 @@ ptr<string> TransportNetwork::ipToString(uint32_t _ip) {
             to_string((uint8_t) ip[2]) + "." + to_string((uint8_t) ip[3]));
 }
 
-ptr<NetworkMessageEnvelope> TransportNetwork::receiveMessage() {
-    auto buf = make_shared<Buffer>(MAX_CONSENSUS_MESSAGE_LEN);
-    uint64_t readBytes = readMessageFromNetwork(buf);
+ptr<vector<ptr<NetworkMessageEnvelope>>> TransportNetwork::receiveMessages() {
+    uint64_t readBytes = 0;
+    auto data = readMessageFromNetwork(readBytes);
+
+    auto result = make_shared<vector<ptr<NetworkMessageEnvelope>>>();
+
+    if (!NetworkMessageFields::isBatch(data, readBytes)) {
+        // only batches may use the full frame length
+        if (readBytes >= MAX_CONSENSUS_MESSAGE_LEN) {
+            BOOST_THROW_EXCEPTION(InvalidMessageFormatException(
+                                          "Consensus message too large:" + to_string(readBytes), __CLASS_NAME__));
+        }
+        result->push_back(createEnvelope(data, readBytes));
+        return result;
+    }
+
+    auto messages = NetworkMessageFields::unpackBatch(data, readBytes);
+
+    for (auto &&message : *messages) {
+        if (message.second >= MAX_CONSENSUS_MESSAGE_LEN) {
+            BOOST_THROW_EXCEPTION(InvalidMessageFormatException(
+                                          "Batched message too large:" + to_string(message.second), __CLASS_NAME__));
+        }
+        result->push_back(createEnvelope(message.first, message.second));
+    }
+
+    return result;
+}
 
-    auto msg = make_shared<string>((const char *) buf->getBuf()->data(), readBytes);
+ptr<NetworkMessageEnvelope> TransportNetwork::createEnvelope(const char *_data, uint64_t _len) {
 
-    auto mptr = NetworkMessage::parseMessage(msg, getSchain());
+    auto mptr = NetworkMessage::parseMessage(_data, _len, getSchain());
 
     ptr<NodeInfo> realSender = sChain->getNode()->getNodeInfoByIndex(mptr->getSrcSchainIndex());
 
@@ -393,6 +705,10 @@ TransportNetwork::TransportNetwork(Schain &_sChain)
         : Agent(_sChain, false), delayedSends((uint64_t) _sChain.getNodeCount()) {
     auto cfg = _sChain.getNode()->getCfg();
 
+    for (uint64_t i = 0; i < (uint64_t) _sChain.getNodeCount(); i++) {
+        peerSendQueues.push_back(make_shared<PeerSendQueue>(PEER_SEND_QUEUE_SIZE));
+    }
+
     if (cfg.find("catchupBlocks") != cfg.end()) {
         uint64_t catchupBlock = cfg.at("catchupBlocks").get<uint64_t>();
         setCatchupBlocks(catchupBlock);
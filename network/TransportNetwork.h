@@ -34,6 +34,8 @@ class NetworkMessageEnvelope;
 class NodeInfo;
 class NetworkMessage;
 class Buffer;
+class OutgoingFrame;
+class PeerSendQueue;
 class Node;
 class Schain;
 
@@ -51,6 +53,35 @@ class TransportNetwork : public Agent  {
     recursive_mutex deferredMutex;
 
     uint32_t packetLoss = 0;
+
+    // broadcasts of the thread that started a send batch, sent on commitSendBatch()
+    class PendingSends {
+    public:
+        TransportNetwork *owner = nullptr;
+        vector<ptr<NetworkMessage>> messages;
+        // quorum callbacks of the messages, empty if none was passed
+        vector<function<void()>> callbacks;
+    };
+
+    static thread_local PendingSends pendingSends;
+
+    bool isSendBatching() const;
+
+    // packs the messages into frames of at most MAX_CONSENSUS_FRAME_LEN bytes
+    static ptr<vector<ptr<string>>> packFrames(const vector<ptr<NetworkMessage>> &_messages,
+                                               vector<uint64_t> &_framesEnd);
+
+    ptr<NetworkMessageEnvelope> createEnvelope(const char *_data, uint64_t _len);
+
+    // one queue and one sender thread per peer, indexed by schain index - 1
+    vector<ptr<PeerSendQueue>> peerSendQueues;
+
+    vector<ptr<thread>> peerSendThreads;
+
+    void enqueueFrame(const ptr<OutgoingFrame> &_frame);
+
+    void peerSendLoop(schain_index _dstIndex);
+
 public:
     uint32_t getPacketLoss() const;
 
@@ -71,14 +102,32 @@ protected:
      */
     recursive_mutex deferredMessageMutex;
 
-    map<block_id, ptr<vector<ptr<NetworkMessageEnvelope>>>> deferredMessageQueue;
+    // keyed by (block id, round), so that a round change releases just its messages
+    map<pair<block_id, bin_consensus_round>, ptr<vector<ptr<NetworkMessageEnvelope>>>> deferredMessageQueue;
+
+    condition_variable_any deferredMessageCond;
+
+    // set when a block is committed, releases all deferred messages of current blocks
+    bool commitWakeup = false;
 
-    virtual void addToDeferredMessageQueue(ptr<NetworkMessageEnvelope> _me);
+    // (block id, round) pairs whose instances advanced since the last drain
+    vector<pair<block_id, bin_consensus_round>> roundWakeups;
 
-    ptr<vector<ptr<NetworkMessageEnvelope> > > pullMessagesForCurrentBlockID();
+    // counts wakeups, so that a message deferred during a wakeup is not left behind
+    atomic<uint64_t> deferWakeupCounter = 0;
+
+    virtual void addToDeferredMessageQueue(ptr<NetworkMessageEnvelope> _me, uint64_t _wakeupCounter);
+
+    // waits up to _timeoutMs for a wakeup and returns the deferred messages it released
+    ptr<vector<ptr<NetworkMessageEnvelope> > > pullReadyMessages(uint64_t _timeoutMs);
 
     virtual bool sendMessage(const ptr<NodeInfo> &remoteNodeInfo, ptr<NetworkMessage> _msg) = 0;
 
+    virtual bool sendFrame(const ptr<NodeInfo> &_remoteNodeInfo, const ptr<string> &_frame) = 0;
+
+    // waits up to _timeoutMs for the connection to the peer to take more data
+    virtual bool waitUntilWritable(const ptr<NodeInfo> &_remoteNodeInfo, uint64_t _timeoutMs) = 0;
+
 
 
 
@@ -94,6 +143,11 @@ public:
 
     void deferredMessagesLoop();
 
+    // wake the deferred messages loop instead of having it poll
+    void notifyBlockCommitted();
+
+    void notifyRoundAdvanced(block_id _blockID, bin_consensus_round _round);
+
     void networkReadLoop();
 
     void waitUntilExit();
@@ -102,11 +156,25 @@ public:
 
     static ptr<string> ipToString(uint32_t _ip);
 
-    void broadcastMessage(ptr<NetworkMessage> _m);
+    // queues the message for every peer and returns. _onQuorum runs on a sender
+    // thread once the message has been sent to 2/3 of the chain
+    void broadcastMessage(ptr<NetworkMessage> _m, function<void()> _onQuorum = nullptr);
 
-    ptr<NetworkMessageEnvelope> receiveMessage();
+    uint64_t getPeerSendQueueDepth(schain_index _dstIndex);
 
-    virtual uint64_t readMessageFromNetwork(ptr<Buffer> buf) = 0;
+    uint64_t getTotalSendQueueDepth();
+
+    // a received frame holds either one message or a batch of messages
+    ptr<vector<ptr<NetworkMessageEnvelope>>> receiveMessages();
+
+    // broadcasts of the calling thread are collected and sent on commitSendBatch(),
+    // with all messages for a peer packed into one frame
+    void startSendBatch();
+
+    void commitSendBatch();
+
+    // returns the received bytes, which stay valid until the next read of the calling thread
+    virtual const char *readMessageFromNetwork(uint64_t &_len) = 0;
 
     static bool validateIpAddress(ptr<string> &_ip);
 
@@ -124,5 +192,11 @@ public:
 
     void addToDelayedSends(ptr<NetworkMessage> _m, ptr<NodeInfo> dstNodeInfo);
 
-    void trySendingDelayedSends();
+    // sends delayed messages to the peer until its socket stops taking them,
+    // dropping messages of blocks that are already committed. Returns the number sent
+    uint64_t trySendingDelayedSends(const ptr<NodeInfo> &_dstNodeInfo);
+
+    uint64_t getDelayedSendsBacklog(schain_index _dstIndex);
+
+    uint64_t getTotalDelayedSendsBacklog();
 };
@@ -57,7 +57,41 @@ using namespace std;
 bool ZMQNetwork::sendMessage(const ptr<NodeInfo> &_remoteNodeInfo, ptr<NetworkMessage> _msg) {
 
 
-    auto buf = _msg->serializeToString();
+    auto buf = sChain->getNode()->isBinaryNetworkMessages() ? _msg->serializeToBinary() :
+               _msg->serializeToString();
+
+    return sendFrame(_remoteNodeInfo, buf);
+}
+
+bool ZMQNetwork::waitUntilWritable(const ptr<NodeInfo> &_remoteNodeInfo, uint64_t _timeoutMs) {
+
+    void *s = sChain->getNode()->getSockets()->consensusZMQSocket->getDestinationSocket(
+            _remoteNodeInfo->getBaseIP(), _remoteNodeInfo->getPort());
+
+    // client sockets are thread safe, so they need a poller rather than zmq_poll
+    void *poller = zmq_poller_new();
+
+    CHECK_STATE(poller);
+
+    zmq_poller_event_t event;
+
+    int rc = zmq_poller_add(poller, s, nullptr, ZMQ_POLLOUT);
+
+    if (rc == 0) {
+        rc = zmq_poller_wait(poller, &event, (long) _timeoutMs);
+    } else {
+        // could not poll the socket, so just wait
+        usleep(1000 * _timeoutMs);
+    }
+
+    zmq_poller_destroy(&poller);
+
+    return rc == 0;
+}
+
+bool ZMQNetwork::sendFrame(const ptr<NodeInfo> &_remoteNodeInfo, const ptr<string> &_frame) {
+
+    CHECK_ARGUMENT(_frame);
 
     auto ip = _remoteNodeInfo->getBaseIP();
 
@@ -66,23 +100,22 @@ bool ZMQNetwork::sendMessage(const ptr<NodeInfo> &_remoteNodeInfo, ptr<NetworkMe
     void *s = sChain->getNode()->getSockets()->consensusZMQSocket->getDestinationSocket(ip, port);
 
 #ifdef ZMQ_NONBLOCKING
-    return interruptableSend(s, buf->data(), buf->size(), true);
+    return interruptableSend(s, _frame->data(), _frame->size(), true);
 #else
-    return interruptableSend(s, buf->data(), buf->size(), false);
+    return interruptableSend(s, _frame->data(), _frame->size(), false);
 #endif
 
 
 }
 
 
-uint64_t ZMQNetwork::interruptableRecv(void *_socket, void *_buf, size_t _len, int _flags) {
+uint64_t ZMQNetwork::interruptableRecv(void *_socket, zmq_msg_t *_msg, int _flags) {
 
     int rc = -1;
 
     do {
 
-        rc = zmq_recv(_socket, _buf,
-                      _len, _flags);
+        rc = zmq_msg_recv(_msg, _socket, _flags);
         if (this->getNode()->isExitRequested()) {
             LOG(debug, getThreadName() + " zmq debug: closing = " + to_string((uint64_t)_socket));
             int linger = 1;
@@ -105,7 +138,10 @@ uint64_t ZMQNetwork::interruptableRecv(void *_socket, void *_buf, size_t _len, i
 bool ZMQNetwork::interruptableSend(void *_socket, void *_buf, size_t _len, bool _isNonBlocking) {
 
 
-    usleep(1000 * sChain->getNode()->getSimulateNetworkWriteDelayMs());
+    auto delayMs = sChain->getNode()->getSimulateNetworkWriteDelayMs();
+
+    if (delayMs > 0)
+        usleep(1000 * delayMs);
 
     int rc = -1;
 
@@ -142,18 +178,31 @@ bool ZMQNetwork::interruptableSend(void *_socket, void *_buf, size_t _len, bool
 }
 
 
-uint64_t ZMQNetwork::readMessageFromNetwork(ptr<Buffer> buf) {
+const char *ZMQNetwork::readMessageFromNetwork(uint64_t &_len) {
+
+    // each reading thread keeps one message, so ZMQ frames are parsed
+    // in place instead of being copied into a fresh buffer per message
+    static thread_local class ReceiveMsg {
+    public:
+        zmq_msg_t msg;
+
+        ReceiveMsg() { zmq_msg_init(&msg); }
+
+        ~ReceiveMsg() { zmq_msg_close(&msg); }
+    } receiveMsg;
 
     auto s = sChain->getNode()->getSockets()->consensusZMQSocket->getReceiveSocket();
 
-    auto rc = interruptableRecv(s, buf->getBuf()->data(), MAX_CONSENSUS_MESSAGE_LEN, 0);
+    auto rc = interruptableRecv(s, &receiveMsg.msg, 0);
 
-    if ((uint64_t) rc >= MAX_CONSENSUS_MESSAGE_LEN) {
+    if (rc >= MAX_CONSENSUS_FRAME_LEN) {
         BOOST_THROW_EXCEPTION(NetworkProtocolException("Consensus essage length too large:" +
                                        to_string(rc), __CLASS_NAME__));
     }
 
-    return rc;
+    _len = rc;
+
+    return (const char *) zmq_msg_data(&receiveMsg.msg);
 
 }
 
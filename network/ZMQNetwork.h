@@ -39,6 +39,8 @@ class Schain;
 
 class TransactionList;
 
+struct zmq_msg_t;
+
 
 class ZMQNetwork : public TransportNetwork {
 
@@ -46,15 +48,19 @@ class ZMQNetwork : public TransportNetwork {
 public:
 
 
-    uint64_t interruptableRecv(void *_socket, void *_buf, size_t _len, int _flags);
+    uint64_t interruptableRecv(void *_socket, zmq_msg_t *_msg, int _flags);
 
     bool interruptableSend(void *_socket, void *_buf, size_t _len, bool _isNonBlocking = false);
 
-    uint64_t readMessageFromNetwork(ptr<Buffer> buf);
+    const char *readMessageFromNetwork(uint64_t &_len) override;
 
     ZMQNetwork(Schain &_schain);
 
     bool sendMessage(const ptr<NodeInfo> &_remoteNodeInfo, ptr<NetworkMessage> _msg);
 
+    bool sendFrame(const ptr<NodeInfo> &_remoteNodeInfo, const ptr<string> &_frame) override;
+
+    bool waitUntilWritable(const ptr<NodeInfo> &_remoteNodeInfo, uint64_t _timeoutMs) override;
+
 };
 
@@ -66,6 +66,8 @@
 #include "ConsensusInterface.h"
 #include "Node.h"
 
+#include <sys/eventfd.h>
+
 using namespace std;
 
 Node::Node(const nlohmann::json &_cfg, ConsensusEngine *_consensusEngine) {
@@ -78,6 +80,12 @@ Node::Node(const nlohmann::json &_cfg, ConsensusEngine *_consensusEngine) {
     this->exitRequested = false;
     this->cfg = _cfg;
 
+    this->exitEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (exitEventFd < 0) {
+        BOOST_THROW_EXCEPTION(FatalError("Could not create exit eventfd:" + string(strerror(errno))));
+    }
+
     try {
         initParamsFromConfig();
     } catch (...) {
@@ -102,34 +110,59 @@ void Node::initLevelDBs() {
     string blockProposalDBPrefix = "/block_proposals_" + to_string(nodeID) + ".db";
 
 
-    blockDB = make_shared<BlockDB>(getSchain(), dbDir, blockDBPrefix, getNodeID(), getBlockDBSize());
-    randomDB = make_shared<RandomDB>(getSchain(), dbDir, randomDBPrefix, getNodeID(), getRandomDBSize());
-    priceDB = make_shared<PriceDB>(getSchain(), dbDir, priceDBPrefix, getNodeID(), getPriceDBSize());
+    auto largeValues = LevelDBProfile::largeValueDefaults();
+    auto smallValues = LevelDBProfile::smallValueDefaults();
+
+    blockDB = make_shared<BlockDB>(getSchain(), dbDir, blockDBPrefix, getNodeID(), getBlockDBSize(),
+                                   getLevelDBProfile("blockDB", largeValues));
+    randomDB = make_shared<RandomDB>(getSchain(), dbDir, randomDBPrefix, getNodeID(), getRandomDBSize(),
+                                     getLevelDBProfile("randomDB", smallValues));
+    priceDB = make_shared<PriceDB>(getSchain(), dbDir, priceDBPrefix, getNodeID(), getPriceDBSize(),
+                                   getLevelDBProfile("priceDB", smallValues));
     proposalHashDB = make_shared<ProposalHashDB>(getSchain(), dbDir, proposalHashDBPrefix, getNodeID(),
-                                                 getProposalHashDBSize());
+                                                 getProposalHashDBSize(),
+                                                 getLevelDBProfile("proposalHashDB", smallValues));
     proposalVectorDB = make_shared<ProposalVectorDB>(getSchain(), dbDir, proposalVectorDBPrefix, getNodeID(),
-                                                 getProposalVectorDBSize());
+                                                 getProposalVectorDBSize(),
+                                                 getLevelDBProfile("proposalVectorDB", smallValues));
 
     outgoingMsgDB = make_shared<MsgDB>(getSchain(), dbDir, outgoingMsgDBPrefix, getNodeID(),
-                                       getOutgoingMsgDBSize());
+                                       getOutgoingMsgDBSize(), getLevelDBProfile("outgoingMsgDB", smallValues));
 
     incomingMsgDB = make_shared<MsgDB>(getSchain(), dbDir, incomingMsgDBPrefix, getNodeID(),
-                                       getIncomingMsgDBSize());
+                                       getIncomingMsgDBSize(), getLevelDBProfile("incomingMsgDB", smallValues));
 
     consensusStateDB = make_shared<ConsensusStateDB>(getSchain(), dbDir, consensusStateDBPrefix, getNodeID(),
-                                       getConsensusStateDBSize());
+                                       getConsensusStateDBSize(),
+                                       getLevelDBProfile("consensusStateDB", smallValues));
 
 
     blockSigShareDB = make_shared<BlockSigShareDB>(getSchain(), dbDir, blockSigShareDBPrefix, getNodeID(),
-                                                   getBlockSigShareDBSize());
+                                                   getBlockSigShareDBSize(),
+                                                   getLevelDBProfile("blockSigShareDB", smallValues));
     daSigShareDB = make_shared<DASigShareDB>(getSchain(), dbDir, daSigShareDBPrefix, getNodeID(),
-                                             getDaSigShareDBSize());
-    daProofDB = make_shared<DAProofDB>(getSchain(), dbDir, daProofDBPrefix, getNodeID(), getDaProofDBSize());
+                                             getDaSigShareDBSize(), getLevelDBProfile("daSigShareDB", smallValues));
+    daProofDB = make_shared<DAProofDB>(getSchain(), dbDir, daProofDBPrefix, getNodeID(), getDaProofDBSize(),
+                                       getLevelDBProfile("daProofDB", smallValues));
     blockProposalDB = make_shared<BlockProposalDB>(getSchain(), dbDir, blockProposalDBPrefix, getNodeID(),
-                                                   getBlockProposalDBSize());
+                                                   getBlockProposalDBSize(),
+                                                   getLevelDBProfile("blockProposalDB", largeValues),
+                                                   getProposalCacheBlocks());
 
 }
 
+void Node::refreshLevelDBSizes() {
+
+    vector<ptr<CacheLevelDB>> dbs = {blockDB, randomDB, priceDB, proposalHashDB, proposalVectorDB,
+                                     outgoingMsgDB, incomingMsgDB, consensusStateDB, blockSigShareDB,
+                                     daSigShareDB, daProofDB, blockProposalDB};
+
+    for (auto &&db : dbs) {
+        if (db)
+            db->refreshActiveDBSize();
+    }
+}
+
 void Node::initLogging() {
     log = make_shared<Log>(nodeID, getConsensusEngine());
 
@@ -161,6 +194,9 @@ void Node::initParamsFromConfig() {
     blockProposalHistorySize = getParamUint64("blockProposalHistorySize", BLOCK_PROPOSAL_HISTORY_SIZE);
     committedTransactionsHistory = getParamUint64("committedTransactionsHistory", COMMITTED_TRANSACTIONS_HISTORY);
     maxCatchupDownloadBytes = getParamUint64("maxCatchupDownloadBytes", MAX_CATCHUP_DOWNLOAD_BYTES);
+    maxCatchupResponseBytes = getParamUint64("maxCatchupResponseBytes", MAX_CATCHUP_RESPONSE_BYTES);
+    maxCatchupResponseBlocks = getParamUint64("maxCatchupResponseBlocks", MAX_CATCHUP_RESPONSE_BLOCKS);
+    catchupParallelPeers = getParamUint64("catchupParallelPeers", CATCHUP_PARALLEL_PEERS);
     maxTransactionsPerBlock = getParamUint64("maxTransactionsPerBlock", MAX_TRANSACTIONS_PER_BLOCK);
     minBlockIntervalMs = getParamUint64("minBlockIntervalMs", MIN_BLOCK_INTERVAL_MS);
     blockDBSize = getParamUint64("blockDBSize", BLOCK_DB_SIZE);
@@ -176,6 +212,9 @@ void Node::initParamsFromConfig() {
     randomDBSize = getParamUint64("randomDBSize", RANDOM_DB_SIZE);
     priceDBSize = getParamUint64("priceDBSize", PRICE_DB_SIZE);
     blockProposalDBSize = getParamUint64("blockProposalDBSize", BLOCK_PROPOSAL_DB_SIZE);
+    proposalCacheBlocks = getParamUint64("proposalCacheBlocks", PROPOSAL_CACHE_BLOCKS);
+    binaryNetworkMessages = getParamUint64("binaryNetworkMessages", BINARY_NETWORK_MESSAGES) != 0;
+    erasureCodedFragments = getParamUint64("erasureCodedFragments", ERASURE_CODED_FRAGMENTS) != 0;
 
     auto emptyBlockIntervalMsTmp = getParamInt64("emptyBlockIntervalMs", EMPTY_BLOCK_INTERVAL_MS);
 
@@ -207,7 +246,10 @@ uint64_t Node::getIncomingMsgDBSize() const {
     return incomingMsgDBSize;
 }
 
-Node::~Node() {}
+Node::~Node() {
+    if (exitEventFd >= 0)
+        close(exitEventFd);
+}
 
 
 void Node::startServers() {
@@ -383,6 +425,12 @@ void Node::exit() {
 
     exitRequested = true;
 
+    // the counter is never read back, so the eventfd stays readable for every poller
+    uint64_t one = 1;
+    if (write(exitEventFd, &one, sizeof(one)) < 0) {
+        LOG(err, "Could not signal exit eventfd");
+    }
+
     releaseGlobalClientBarrier();
     releaseGlobalServerBarrier();
     LOG(info, "Exit requested");
@@ -58,6 +58,7 @@ class BLSPublicKey;
 class BLSPrivateKeyShare;
 
 class CacheLevelDB;
+class LevelDBProfile;
 class BlockDB;
 class BlockProposalDB;
 class RandomDB;
@@ -111,6 +112,9 @@ class Node {
 
     std::atomic_bool exitRequested;
 
+    // becomes readable once exit is requested, so blocked network reads wake up immediately
+    int exitEventFd = -1;
+
     ptr<Log> log = nullptr;
     ptr<string> name = nullptr;
 
@@ -192,6 +196,14 @@ class Node {
 
     uint64_t maxCatchupDownloadBytes;
 
+    // a catchup response stops after this many bytes or blocks, the client asks again for the rest
+    uint64_t maxCatchupResponseBytes;
+
+    uint64_t maxCatchupResponseBlocks;
+
+    // peers downloading block ranges at once when a node is far behind, 1 disables parallel catchup
+    uint64_t catchupParallelPeers;
+
 
     uint64_t maxTransactionsPerBlock;
 
@@ -209,6 +221,13 @@ class Node {
     uint64_t randomDBSize;
     uint64_t priceDBSize;
     uint64_t blockProposalDBSize;
+    uint64_t proposalCacheBlocks;
+
+    // send consensus messages in the binary encoding; set to false while old nodes are in the chain
+    bool binaryNetworkMessages;
+
+    // download proposals as k-of-n erasure coded fragments; set to false while old nodes are in the chain
+    bool erasureCodedFragments;
 
     ptr<BLSPublicKey> blsPublicKey;
     ptr<BLSPrivateKeyShare> blsPrivateKey;
@@ -248,6 +267,10 @@ public:
     uint64_t getDaSigShareDBSize() const;
     uint64_t getDaProofDBSize() const;
     uint64_t getBlockProposalDBSize() const;
+    uint64_t getProposalCacheBlocks() const;
+
+    bool isBinaryNetworkMessages() const;
+    bool isErasureCodedFragments() const;
     bool isBlsEnabled() const;
     uint64_t getSimulateNetworkWriteDelayMs() const;
     ptr<BLSPublicKey> getBlsPublicKey() const;
@@ -256,6 +279,8 @@ public:
 
 
     void initLevelDBs();
+
+    void refreshLevelDBSizes();
     bool isStarted() const;
 
 
@@ -299,6 +324,8 @@ public:
 
     bool isExitRequested();
 
+    int getExitEventFd();
+
     void exitCheck();
 
 
@@ -329,6 +356,12 @@ public:
 
     uint64_t getMaxCatchupDownloadBytes() const;
 
+    uint64_t getMaxCatchupResponseBytes() const;
+
+    uint64_t getMaxCatchupResponseBlocks() const;
+
+    uint64_t getCatchupParallelPeers() const;
+
     uint64_t getMaxTransactionsPerBlock() const;
 
     uint64_t getMinBlockIntervalMs() const;
@@ -341,6 +374,10 @@ public:
 
     ptr<string> getParamString(const string &_paramName, string &_paramDefault);
 
+    // reads <_dbName>CacheSize, <_dbName>WriteBufferSize, <_dbName>MaxOpenFiles, <_dbName>Compression,
+    // <_dbName>FilterBits and <_dbName>BlockSize, falling back to _defaults
+    LevelDBProfile getLevelDBProfile(const string &_dbName, const LevelDBProfile &_defaults);
+
     void initParamsFromConfig();
 
     void initLogging();
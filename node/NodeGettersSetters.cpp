@@ -116,6 +116,15 @@ int64_t Node::getParamInt64(const string &_paramName, uint64_t _paramDefault) {
 }
 
 
+LevelDBProfile Node::getLevelDBProfile(const string &_dbName, const LevelDBProfile &_defaults) {
+    return LevelDBProfile(getParamUint64(_dbName + "CacheSize", _defaults.getBlockCacheSize()),
+                          getParamUint64(_dbName + "WriteBufferSize", _defaults.getWriteBufferSize()),
+                          getParamUint64(_dbName + "MaxOpenFiles", _defaults.getMaxOpenFiles()),
+                          getParamUint64(_dbName + "Compression", _defaults.isCompression()) != 0,
+                          getParamUint64(_dbName + "FilterBits", _defaults.getFilterBits()),
+                          getParamUint64(_dbName + "BlockSize", _defaults.getBlockSize()));
+}
+
 ptr<string> Node::getParamString(const string &_paramName, string &_paramDefault) {
     try {
         if (cfg.find(_paramName) != cfg.end()) {
@@ -255,6 +264,18 @@ uint64_t Node::getMaxCatchupDownloadBytes() const {
     return maxCatchupDownloadBytes;
 }
 
+uint64_t Node::getMaxCatchupResponseBytes() const {
+    return maxCatchupResponseBytes;
+}
+
+uint64_t Node::getMaxCatchupResponseBlocks() const {
+    return maxCatchupResponseBlocks;
+}
+
+uint64_t Node::getCatchupParallelPeers() const {
+    return catchupParallelPeers;
+}
+
 
 uint64_t Node::getMaxTransactionsPerBlock() const {
     return maxTransactionsPerBlock;
@@ -312,6 +333,10 @@ bool Node::isExitRequested() {
     return exitRequested;
 }
 
+int Node::getExitEventFd() {
+    return exitEventFd;
+}
+
 
 bool Node::isBlsEnabled() const {
     return isBLSEnabled;
@@ -368,6 +393,18 @@ uint64_t Node::getBlockProposalDBSize() const {
     return blockProposalDBSize;
 }
 
+uint64_t Node::getProposalCacheBlocks() const {
+    return proposalCacheBlocks;
+}
+
+bool Node::isBinaryNetworkMessages() const {
+    return binaryNetworkMessages;
+}
+
+bool Node::isErasureCodedFragments() const {
+    return erasureCodedFragments;
+}
+
 ConsensusEngine *Node::getConsensusEngine() const {
     return consensusEngine;
 }
@@ -542,6 +542,9 @@ void BinConsensusInstance::decide(bin_consensus_value _b) {
 
     setDecidedRoundAndValue(getCurrentRound(), bin_consensus_value(_b));
 
+    // messages of the next round are accepted once a round is decided
+    getSchain()->getNode()->getNetwork()->notifyRoundAdvanced(getBlockID(), getCurrentRound());
+
     addDecideToGlobalHistory(decidedValue);
 
     auto msg = make_shared<ChildBVDecidedMessage>((bool) _b, *this, this->getProtocolKey());
@@ -651,6 +654,7 @@ void BinConsensusInstance::setCurrentRound(bin_consensus_round _currentRound) {
     currentRound = _currentRound;
     getSchain()->getNode()->getConsensusStateDB()->writeCR(getBlockID(),
                                                            blockProposerIndex, _currentRound);
+    getSchain()->getNode()->getNetwork()->notifyRoundAdvanced(getBlockID(), _currentRound);
 }
 
 bool BinConsensusInstance::decided() const {
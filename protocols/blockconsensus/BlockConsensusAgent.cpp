@@ -49,7 +49,6 @@
 #include "db/BlockSigShareDB.h"
 #include "db/BlockDB.h"
 #include "blockfinalize/client/BlockFinalizeDownloader.h"
-#include "blockfinalize/client/BlockFinalizeDownloaderThreadPool.h"
 #include "thirdparty/lrucache.hpp"
 
 #include "protocols/ProtocolKey.h"